@@ -7,7 +7,7 @@
 #include <q/support/literals.hpp>
 #include <q/synth/saw_osc.hpp>
 #include <q/synth/envelope_gen.hpp>
-#include <q/fx/svf.hpp>
+#include <q/fx/modulated_svf.hpp>
 #include <q/fx/clip.hpp>
 #include <q_io/audio_stream.hpp>
 #include <q_io/midi_stream.hpp>
@@ -21,9 +21,11 @@
 ///////////////////////////////////////////////////////////////////////////////
 // A polyphonic, MIDI-controlled sawtooth synthesizer. Each note plays on its
 // own voice: a bandwidth-limited sawtooth through an ADSR envelope that sweeps
-// a resonant low-pass (q::svf) and the amplifier. A fixed pool of voices is
-// allocated per note-on (a free voice, or the oldest one stolen), and the
-// active voices are summed into the output.
+// a resonant low-pass (q::modulated_svf) and the amplifier. A fixed pool of
+// voices is allocated per note-on (a free voice, or the oldest one stolen),
+// and the active voices are rendered in blocks and summed into the output.
+// The voices share one cutoff_table, so sweeping the filters costs no tan
+// per sample, per voice.
 //
 // Polyphony needs no special library support: a voice is just an instance of
 // the same fine-grained building blocks the monophonic square_synth uses, and
@@ -38,9 +40,15 @@ namespace midi = q::midi_1_0;
 // One synth voice.
 struct voice
 {
-   voice(q::adsr_envelope_gen::config env_cfg, float sps)
+   static constexpr std::size_t block_size = 64;
+
+   voice(
+      q::adsr_envelope_gen::config env_cfg
+    , q::cutoff_table const& table
+    , float sps
+   )
     : _env{env_cfg, sps}
-    , _filter{1_kHz, sps, 2.0}      // cutoff is set per sample; sps; resonance Q
+    , _filter{table, 1_kHz, 2.0}    // cutoff is set per sample; resonance Q
     , _sps{sps}
    {}
 
@@ -55,17 +63,27 @@ struct voice
 
    bool active() const { return !_env.in_idle_phase(); }
 
-   float operator()()
+   // Render n (up to block_size) frames, added to mix.
+   void render(float* mix, std::size_t n)
    {
-      auto env = _env() * _velocity;
-      // Sweep the cutoff with the envelope, then amplify by it.
-      _filter.cutoff(q::frequency{60.0 + (env * 6000.0)}, _sps);
-      return _filter(q::saw(_phase++)) * env;
+      float out[block_size], cutoff[block_size], env[block_size];
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         env[i] = _env() * _velocity;
+         // Sweep the cutoff with the envelope
+         cutoff[i] = 60.0f + (env[i] * 6000.0f);
+         out[i] = q::saw(_phase++);
+      }
+      _filter.process(out, out, cutoff, n);
+
+      // ... then amplify by it.
+      for (std::size_t i = 0; i != n; ++i)
+         mix[i] += out[i] * env[i];
    }
 
    q::phase_iterator    _phase;
    q::adsr_envelope_gen _env;
-   q::svf               _filter;
+   q::modulated_svf     _filter;
    float                _sps;
    float                _velocity = 0.0f;
    std::uint8_t         _key = 0;       // the MIDI key this voice is playing
@@ -81,10 +99,11 @@ struct poly_synth : q::audio_stream
 
    poly_synth(q::adsr_envelope_gen::config env_cfg, int device_id)
     : audio_stream(q::audio_device::get(device_id), 0, 2)
+    , _table{float(sampling_rate())}
    {
       _voices.reserve(num_voices);
       for (std::size_t i = 0; i != num_voices; ++i)
-         _voices.emplace_back(env_cfg, sampling_rate());
+         _voices.emplace_back(env_cfg, _table, sampling_rate());
    }
 
    void note_on(std::uint8_t key, float velocity)
@@ -103,13 +122,16 @@ struct poly_synth : q::audio_stream
    {
       auto left = out[0];
       auto right = out[1];
-      for (auto frame : out.frames)
+      auto const n = out.frames.size();
+      for (std::size_t i = 0; i < n; i += voice::block_size)
       {
-         auto mix = 0.0f;
+         auto const m = std::min(voice::block_size, n - i);
+         float mix[voice::block_size] = {};
          for (auto& v : _voices)
             if (v.active())
-               mix += v();
-         left[frame] = right[frame] = _clip(mix * master_gain);
+               v.render(mix, m);
+         for (std::size_t j = 0; j != m; ++j)
+            left[i + j] = right[i + j] = _clip(mix[j] * master_gain);
       }
    }
 
@@ -128,6 +150,7 @@ private:
       return v;
    }
 
+   q::cutoff_table    _table;
    std::vector<voice> _voices;
    q::cubic_clip      _clip;
    std::uint64_t      _order = 0;
@@ -0,0 +1,203 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_BIQUAD_BLOCK_HPP_OCTOBER_17_2026)
+#define CYCFI_Q_BIQUAD_BLOCK_HPP_OCTOBER_17_2026
+
+#include <cstddef>
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+namespace cycfi::q::detail
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // The block loops of biquad::process. The coefficients are those of
+   // biquad: b0, b1, b2 (feed forward) and a1, a2 (feedback), and the
+   // state is biquad's direct form I state: the last two inputs, x1, x2,
+   // and the last two outputs, y1, y2, updated on return, so that the
+   // block and the per-sample forms can be mixed freely.
+   //
+   // biquad_block_tdf2: transposed direct form II. The state is converted
+   // to the two TDF-II accumulators on entry and kept in registers across
+   // the block.
+   //
+   // biquad_block_sse: four outputs per iteration, with SSE2. The feed
+   // forward part, u[k] = b0 x[k] + b1 x[k-1] + b2 x[k-2], is computed for
+   // the four samples at once. The feedback part is unrolled by four: each
+   // output y[k+i] (0 <= i < 4) is a linear combination of u[k] to u[k+3]
+   // and of the two outputs before the group, y[k-1] and y[k-2]:
+   //
+   //    y[k..k+3] = U0 u[k] + U1 u[k+1] + U2 u[k+2] + U3 u[k+3]
+   //              + Y1 y[k-1] + Y2 y[k-2]
+   //
+   // where the 4-element columns U0..U3, Y1 and Y2 are the responses of
+   // the recurrence to each of these inputs alone. Only the Y1 and Y2
+   // terms depend on the previous group, so the loop carried dependency
+   // is a few vector operations per four samples instead of a multiply
+   // and two adds per sample. The feed forward part is in single
+   // precision, like the per-sample filter, but the columns, the
+   // products and the output state are in double precision: with the
+   // poles near z = 1 (low cutoffs, e.g. DC blockers and low shelves),
+   // the columns are large and nearly cancel.
+   //
+   // Returns the number of samples processed, a multiple of 4. The rest,
+   // if any, is for biquad_block_tdf2.
+   ////////////////////////////////////////////////////////////////////////////
+   inline void biquad_block_tdf2(
+      float b0, float b1, float b2, float a1, float a2
+    , float& x1, float& x2, float& y1, float& y2
+    , float const* in, float* out, std::size_t n
+   )
+   {
+      if (n == 0)
+         return;
+
+      auto s1 = b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+      auto s2 = b2 * x1 - a2 * y1;
+      auto px1 = x1, px2 = x2, py1 = y1, py2 = y2;
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         auto x = in[i];
+         auto y = b0 * x + s1;
+         s1 = (b1 * x + s2) - a1 * y;
+         s2 = b2 * x - a2 * y;
+         out[i] = y;
+         px2 = px1;
+         px1 = x;
+         py2 = py1;
+         py1 = y;
+      }
+      x1 = px1;
+      x2 = px2;
+      y1 = py1;
+      y2 = py2;
+   }
+
+#if defined(__SSE2__)
+   inline std::size_t biquad_block_sse(
+      float b0, float b1, float b2, float a1, float a2
+    , float& x1, float& x2, float& y1, float& y2
+    , float const* in, float* out, std::size_t n
+   )
+   {
+      auto const groups = n / 4;
+      if (groups == 0)
+         return 0;
+
+      // The columns: run the recurrence y[i] = u[i] - a1 y[i-1] - a2 y[i-2]
+      // over four samples, for each input alone, in double precision
+      auto column =
+         [a1, a2](double const (&u)[4], double ym1, double ym2, double (&y)[4])
+         {
+            for (int i = 0; i != 4; ++i)
+            {
+               y[i] = u[i] - a1 * ym1 - a2 * ym2;
+               ym2 = ym1;
+               ym1 = y[i];
+            }
+         };
+
+      constexpr double e[4][4] =
+         { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
+      constexpr double zero[4] = { 0, 0, 0, 0 };
+
+      double c[4][4], c1[4], c2[4], cs[4];
+      for (int i = 0; i != 4; ++i)
+         column(e[i], 0, 0, c[i]);
+      column(zero, 1, 0, c1);
+      column(zero, 0, 1, c2);
+
+      // Y1 y[k-1] + Y2 y[k-2] = (Y1 + Y2) y[k-1] - Y2 (y[k-1] - y[k-2]).
+      // At low frequencies, y[k-1] and y[k-2] are close, and Y1 and Y2
+      // large and of opposite signs. The sum and the difference are much
+      // better conditioned.
+      for (int i = 0; i != 4; ++i)
+      {
+         cs[i] = c1[i] + c2[i];
+         c2[i] = -c2[i];
+      }
+
+      // The columns, in two halves: outputs 0 and 1, and outputs 2 and 3.
+      // U2 and U3 are zero for outputs 0 and 1.
+      auto lo = [](double const (&y)[4]) { return _mm_setr_pd(y[0], y[1]); };
+      auto hi = [](double const (&y)[4]) { return _mm_setr_pd(y[2], y[3]); };
+
+      auto const u0_lo = lo(c[0]), u0_hi = hi(c[0]);
+      auto const u1_lo = lo(c[1]), u1_hi = hi(c[1]);
+      auto const u2_hi = hi(c[2]);
+      auto const u3_hi = hi(c[3]);
+      auto const cys_lo = lo(cs), cys_hi = hi(cs);
+      auto const cyd_lo = lo(c2), cyd_hi = hi(c2);
+
+      auto const vb0 = _mm_set1_ps(b0);
+      auto const vb1 = _mm_set1_ps(b1);
+      auto const vb2 = _mm_set1_ps(b2);
+
+      // prev holds the previous four inputs, in lanes 2 and 3 for the two
+      // we need, and yp the previous two outputs, y[k-2] and y[k-1].
+      auto prev = _mm_setr_ps(0, 0, x2, x1);
+      auto yp = _mm_setr_pd(y2, y1);
+
+      for (std::size_t g = 0; g != groups; ++g)
+      {
+         auto cur = _mm_loadu_ps(in + 4*g);
+
+         // x[k-1..k+2] and x[k-2..k+1]
+         auto t = _mm_shuffle_ps(prev, cur, _MM_SHUFFLE(1, 0, 3, 3));
+         auto xm1 = _mm_shuffle_ps(t, cur, _MM_SHUFFLE(2, 1, 2, 0));
+         auto xm2 = _mm_shuffle_ps(prev, cur, _MM_SHUFFLE(1, 0, 3, 2));
+
+         auto u = _mm_add_ps(
+            _mm_mul_ps(vb0, cur)
+          , _mm_add_ps(_mm_mul_ps(vb1, xm1), _mm_mul_ps(vb2, xm2))
+         );
+
+         // The feedback is in double precision. With the poles near z = 1
+         // (low cutoffs), the columns are large and nearly cancel, and
+         // single precision falls well short of the per-sample filter.
+         auto ud_lo = _mm_cvtps_pd(u);
+         auto ud_hi = _mm_cvtps_pd(_mm_movehl_ps(u, u));
+         auto uk0 = _mm_unpacklo_pd(ud_lo, ud_lo);
+         auto uk1 = _mm_unpackhi_pd(ud_lo, ud_lo);
+         auto uk2 = _mm_unpacklo_pd(ud_hi, ud_hi);
+         auto uk3 = _mm_unpackhi_pd(ud_hi, ud_hi);
+
+         auto ym1 = _mm_unpackhi_pd(yp, yp);
+         auto dy = _mm_sub_pd(ym1, _mm_unpacklo_pd(yp, yp));
+
+         auto y_lo = _mm_add_pd(
+            _mm_add_pd(_mm_mul_pd(u0_lo, uk0), _mm_mul_pd(u1_lo, uk1))
+          , _mm_add_pd(_mm_mul_pd(cys_lo, ym1), _mm_mul_pd(cyd_lo, dy))
+         );
+         auto y_hi = _mm_add_pd(
+            _mm_add_pd(
+               _mm_add_pd(_mm_mul_pd(u0_hi, uk0), _mm_mul_pd(u1_hi, uk1))
+             , _mm_add_pd(_mm_mul_pd(u2_hi, uk2), _mm_mul_pd(u3_hi, uk3))
+            )
+          , _mm_add_pd(_mm_mul_pd(cys_hi, ym1), _mm_mul_pd(cyd_hi, dy))
+         );
+
+         _mm_storeu_ps(out + 4*g, _mm_movelh_ps(_mm_cvtpd_ps(y_lo), _mm_cvtpd_ps(y_hi)));
+         prev = cur;
+         yp = y_hi;
+      }
+
+      alignas(16) float xs[4];
+      alignas(16) double ys[2];
+      _mm_store_ps(xs, prev);
+      _mm_store_pd(ys, yp);
+      x1 = xs[3];
+      x2 = xs[2];
+      y1 = float(ys[1]);
+      y2 = float(ys[0]);
+      return 4 * groups;
+   }
+#endif
+}
+
+#endif
@@ -0,0 +1,121 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_CROSSING_SCAN_HPP_OCTOBER_17_2026)
+#define CYCFI_Q_CROSSING_SCAN_HPP_OCTOBER_17_2026
+
+#include <algorithm>
+#include <cstddef>
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+namespace cycfi::q::detail
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // The inner loops of the zero_crossing_collector block scan. Each one
+   // skips the leading samples that cannot change the collector's state
+   // and returns how many it skipped. The sample at the returned index (if
+   // any) needs the full, per-sample treatment. The sample values tested
+   // are s = in[i] + offset, computed exactly as the per-sample code does.
+   //
+   // scan_low: while the state is low, the next event is a sample above 0.
+   //
+   // scan_high: while the state is high, the next event is a sample below
+   // the hysteresis, or, if check_width is true (the pulse width is not
+   // yet known), a positive sample below 0.3 times the running peak. peak
+   // (in/out) is the running peak of the pulse.
+   //
+   // With SSE2, four samples are tested at a time. A group that may hold
+   // an event is resolved one sample at a time. The width test uses a
+   // slightly larger (hence conservative) ratio in the vector path, since
+   // the exact test is done in double precision.
+   ////////////////////////////////////////////////////////////////////////////
+   inline std::size_t scan_low(float const* in, std::size_t n, float offset)
+   {
+      std::size_t i = 0;
+#if defined(__SSE2__)
+      auto const off = _mm_set1_ps(offset);
+      auto const zero = _mm_setzero_ps();
+      for (; i + 4 <= n; i += 4)
+      {
+         auto s = _mm_add_ps(_mm_loadu_ps(in + i), off);
+         if (_mm_movemask_ps(_mm_cmpgt_ps(s, zero)))
+            break;
+      }
+#endif
+      for (; i != n; ++i)
+      {
+         if (in[i] + offset > 0.0f)
+            break;
+      }
+      return i;
+   }
+
+   inline bool scan_high_scalar(
+      float const* in, std::size_t& i, std::size_t last
+    , float offset, float hysteresis, bool check_width, float& peak)
+   {
+      for (; i != last; ++i)
+      {
+         auto s = in[i] + offset;
+         if (s < hysteresis)
+            return true;
+         if (s > 0.0f)
+         {
+            auto p = std::max(s, peak);
+            if (check_width && s < p * 0.3)
+               return true;
+            peak = p;
+         }
+      }
+      return false;
+   }
+
+#if defined(__SSE2__)
+   inline __m128 hmax(__m128 v)
+   {
+      v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+      return _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+   }
+#endif
+
+   inline std::size_t scan_high(
+      float const* in, std::size_t n
+    , float offset, float hysteresis, bool check_width, float& peak)
+   {
+      std::size_t i = 0;
+#if defined(__SSE2__)
+      auto const off = _mm_set1_ps(offset);
+      auto const hyst = _mm_set1_ps(hysteresis);
+      auto const width_ratio = _mm_set1_ps(0.31f);
+      while (i + 4 <= n)
+      {
+         auto s = _mm_add_ps(_mm_loadu_ps(in + i), off);
+         auto m = hmax(_mm_max_ps(s, _mm_set1_ps(peak)));
+         auto event = _mm_cmplt_ps(s, hyst);
+         if (check_width)
+            event = _mm_or_ps(event, _mm_cmplt_ps(s, _mm_mul_ps(m, width_ratio)));
+
+         if (_mm_movemask_ps(event))
+         {
+            if (scan_high_scalar(in, i, i + 4, offset, hysteresis, check_width, peak))
+               return i;
+         }
+         else
+         {
+            peak = _mm_cvtss_f32(m);
+            i += 4;
+         }
+      }
+#endif
+      scan_high_scalar(in, i, n, offset, hysteresis, check_width, peak);
+      return i;
+   }
+}
+
+#endif
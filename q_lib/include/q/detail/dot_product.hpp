@@ -0,0 +1,126 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_DOT_PRODUCT_HPP_OCTOBER_17_2026)
+#define CYCFI_Q_DOT_PRODUCT_HPP_OCTOBER_17_2026
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#if defined(__AVX__) || defined(__SSE2__)
+# include <immintrin.h>
+#endif
+
+namespace cycfi::q::detail
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // The inner products of the FIR filters: the dot product of n
+   // coefficients, a, and n samples, b.
+   //
+   // a is stored in an aligned_vector, aligned to simd_align bytes, and n
+   // is a multiple of simd_pad (the filters pad their coefficients with
+   // leading zeros). b may have any alignment. For float, with AVX or
+   // SSE2, the products are summed in two vector accumulators, 16 (AVX)
+   // or 8 (SSE2) at a time, then summed horizontally. Other types use the
+   // plain loop.
+   ////////////////////////////////////////////////////////////////////////////
+   constexpr std::size_t simd_align = 32;
+   constexpr std::size_t simd_pad = 8;
+
+   constexpr std::size_t simd_padded(std::size_t n)
+   {
+      return (n + simd_pad - 1) / simd_pad * simd_pad;
+   }
+
+   template <typename T>
+   struct aligned_allocator
+   {
+      using value_type = T;
+
+      aligned_allocator() = default;
+
+      template <typename U>
+      aligned_allocator(aligned_allocator<U> const&) {}
+
+      T* allocate(std::size_t n)
+      {
+         return static_cast<T*>(
+            ::operator new(n * sizeof(T), std::align_val_t{simd_align}));
+      }
+
+      void deallocate(T* p, std::size_t)
+      {
+         ::operator delete(p, std::align_val_t{simd_align});
+      }
+
+      template <typename U>
+      bool operator==(aligned_allocator<U> const&) const { return true; }
+
+      template <typename U>
+      bool operator!=(aligned_allocator<U> const&) const { return false; }
+   };
+
+   template <typename T>
+   using aligned_vector = std::vector<T, aligned_allocator<T>>;
+
+   template <typename T>
+   inline T dot_product(T const* a, T const* b, std::size_t n)
+   {
+      T sum = 0;
+      for (std::size_t i = 0; i != n; ++i)
+         sum += a[i] * b[i];
+      return sum;
+   }
+
+   inline float dot_product(float const* a, float const* b, std::size_t n)
+   {
+#if defined(__AVX__)
+      auto acc0 = _mm256_setzero_ps();
+      auto acc1 = _mm256_setzero_ps();
+      std::size_t i = 0;
+      for (; i + 16 <= n; i += 16)
+      {
+         acc0 = _mm256_add_ps(acc0,
+            _mm256_mul_ps(_mm256_load_ps(a + i), _mm256_loadu_ps(b + i)));
+         acc1 = _mm256_add_ps(acc1,
+            _mm256_mul_ps(_mm256_load_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+      }
+      if (i != n)
+      {
+         acc0 = _mm256_add_ps(acc0,
+            _mm256_mul_ps(_mm256_load_ps(a + i), _mm256_loadu_ps(b + i)));
+      }
+      auto acc = _mm256_add_ps(acc0, acc1);
+      auto sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+#elif defined(__SSE2__)
+      auto acc0 = _mm_setzero_ps();
+      auto acc1 = _mm_setzero_ps();
+      for (std::size_t i = 0; i != n; i += 8)
+      {
+         acc0 = _mm_add_ps(acc0,
+            _mm_mul_ps(_mm_load_ps(a + i), _mm_loadu_ps(b + i)));
+         acc1 = _mm_add_ps(acc1,
+            _mm_mul_ps(_mm_load_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+      }
+      auto sum = _mm_add_ps(acc0, acc1);
+#endif
+
+#if defined(__AVX__) || defined(__SSE2__)
+      // Horizontal sum
+      sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+      sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+      return _mm_cvtss_f32(sum);
+#else
+      float sum = 0.0f;
+      for (std::size_t i = 0; i != n; ++i)
+         sum += a[i] * b[i];
+      return sum;
+#endif
+   }
+}
+
+#endif
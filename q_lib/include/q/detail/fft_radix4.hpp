@@ -0,0 +1,325 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_FFT_RADIX4_HPP_OCTOBER_17_2026)
+#define CYCFI_Q_FFT_RADIX4_HPP_OCTOBER_17_2026
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX__) || defined(__SSE3__)
+# include <immintrin.h>
+#endif
+
+namespace cycfi::q::detail
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // fft_tables: the precomputed state of an n-point complex FFT, computed
+   // once per size.
+   //
+   // swaps holds the bit-reversal permutation as a list of index pairs
+   // (i, j), i < j, to exchange: the permutation is applied with straight
+   // loads and stores, without recomputing the reversed indices.
+   //
+   // twiddles holds the twiddle factors of each radix-4 stage, computed
+   // directly (not by recurrence) in double precision. A stage combines
+   // four transforms of length L into one of length 4L and needs w^k, w^2k
+   // and w^3k, w = exp(-2 pi i / 4L), for 0 <= k < L. Each of these is
+   // stored as a block of L interleaved complex numbers, so that
+   // consecutive k, processed together by the vector paths, are contiguous.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::floating_point T>
+   struct fft_tables
+   {
+      explicit          fft_tables(std::size_t n);
+
+      std::size_t       n;
+      bool              radix2_first;     // log2(n) is odd
+      std::vector<std::uint32_t> swaps;
+      std::vector<T>    twiddles;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // fft_radix4: in-place forward FFT of t.n complex points, interleaved as
+   // in fft<N>, using the tables t.
+   //
+   // The bit-reversal permutation is followed by a radix-2 stage when
+   // log2(n) is odd, then by radix-4 stages. The radix-4 butterfly fuses
+   // two radix-2 stages: with A, B, C, D the k-th points of the four
+   // length-L transforms (in bit-reversed order, A and B are the halves of
+   // the first length-2L transform):
+   //
+   //    b = w^2k B, c = w^k C, d = w^3k D
+   //    X(k)    = (A + b) + (c + d)
+   //    X(k+2L) = (A + b) - (c + d)
+   //    X(k+L)  = (A - b) - i (c - d)
+   //    X(k+3L) = (A - b) + i (c - d)
+   //
+   // which takes 3 complex multiplications per 4 points, instead of 4 for
+   // two radix-2 stages. The first stage (L = 1) has no multiplications.
+   //
+   // The vector paths are chosen at compile time from the target ISA: for
+   // float, AVX (4 complex numbers per step) where L is a multiple of 4,
+   // then SSE3 (2 per step) where L is a multiple of 2, then the scalar
+   // fallback.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::floating_point T>
+   void fft_radix4(T* data, fft_tables<T> const& t);
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::floating_point T>
+   inline fft_tables<T>::fft_tables(std::size_t n_)
+    : n{ n_ }
+   {
+      std::size_t bits = 0;
+      while ((std::size_t(1) << bits) < n)
+         ++bits;
+      radix2_first = bits % 2;
+
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         std::size_t j = 0;
+         for (std::size_t b = 0; b != bits; ++b)
+            j |= ((i >> b) & 1) << (bits - 1 - b);
+         if (i < j)
+         {
+            swaps.push_back(std::uint32_t(i));
+            swaps.push_back(std::uint32_t(j));
+         }
+      }
+
+      constexpr double pi = 3.141592653589793238462643383279502884;
+      for (std::size_t l = radix2_first? 2 : 1; l < n; l *= 4)
+      {
+         for (std::size_t m = 1; m <= 3; ++m)
+         {
+            for (std::size_t k = 0; k != l; ++k)
+            {
+               auto a = -2.0 * pi * double(m * k) / double(4 * l);
+               twiddles.push_back(T(std::cos(a)));
+               twiddles.push_back(T(std::sin(a)));
+            }
+         }
+      }
+   }
+
+   namespace fft_radix4_detail
+   {
+      template <std::floating_point T>
+      inline void permute(T* data, fft_tables<T> const& t)
+      {
+         auto const* s = t.swaps.data();
+         auto const* end = s + t.swaps.size();
+         for (; s != end; s += 2)
+         {
+            auto* a = data + 2*s[0];
+            auto* b = data + 2*s[1];
+            std::swap(a[0], b[0]);
+            std::swap(a[1], b[1]);
+         }
+      }
+
+      template <std::floating_point T>
+      inline void radix2_first(T* data, std::size_t n)
+      {
+         for (std::size_t i = 0; i != 2*n; i += 4)
+         {
+            T tr = data[i+2];
+            T ti = data[i+3];
+            data[i+2] = data[i] - tr;
+            data[i+3] = data[i+1] - ti;
+            data[i] += tr;
+            data[i+1] += ti;
+         }
+      }
+
+      // One radix-4 butterfly on scalars. p points to X(k), with the other
+      // three points at stride s (2L scalars).
+      template <bool Twiddle, std::floating_point T>
+      inline void butterfly(T* p, std::size_t s, T const* w1, T const* w2, T const* w3)
+      {
+         T ar = p[0],   ai = p[1];
+         T br = p[s],   bi = p[s+1];
+         T cr = p[2*s], ci = p[2*s+1];
+         T dr = p[3*s], di = p[3*s+1];
+
+         if constexpr (Twiddle)
+         {
+            T tr = br*w2[0] - bi*w2[1];
+            bi = br*w2[1] + bi*w2[0];
+            br = tr;
+            tr = cr*w1[0] - ci*w1[1];
+            ci = cr*w1[1] + ci*w1[0];
+            cr = tr;
+            tr = dr*w3[0] - di*w3[1];
+            di = dr*w3[1] + di*w3[0];
+            dr = tr;
+         }
+
+         T t0r = ar + br, t0i = ai + bi;
+         T t1r = ar - br, t1i = ai - bi;
+         T t2r = cr + dr, t2i = ci + di;
+         T t3r = cr - dr, t3i = ci - di;
+
+         p[0]     = t0r + t2r;  p[1]     = t0i + t2i;
+         p[2*s]   = t0r - t2r;  p[2*s+1] = t0i - t2i;
+         p[s]     = t1r + t3i;  p[s+1]   = t1i - t3r;
+         p[3*s]   = t1r - t3i;  p[3*s+1] = t1i + t3r;
+      }
+
+      template <std::floating_point T>
+      inline void radix4_stage_scalar(T* data, std::size_t n, std::size_t l, T const* tw)
+      {
+         auto const s = 2*l;
+         for (std::size_t base = 0; base != 2*n; base += 4*s)
+         {
+            if (l == 1)
+            {
+               butterfly<false>(data + base, s, tw, tw, tw);
+               continue;
+            }
+            for (std::size_t k = 0; k != l; ++k)
+            {
+               auto const* w1 = tw + 2*k;
+               butterfly<true>(data + base + 2*k, s, w1, w1 + s, w1 + 2*s);
+            }
+         }
+      }
+
+#if defined(__SSE3__)
+      // (a + ib)(c + id) for two complex numbers per register
+      inline __m128 cmul(__m128 z, __m128 w)
+      {
+         auto wr = _mm_moveldup_ps(w);
+         auto wi = _mm_movehdup_ps(w);
+         auto zs = _mm_shuffle_ps(z, z, _MM_SHUFFLE(2, 3, 0, 1));
+         return _mm_addsub_ps(_mm_mul_ps(z, wr), _mm_mul_ps(zs, wi));
+      }
+
+      inline void radix4_stage_sse(float* data, std::size_t n, std::size_t l, float const* tw)
+      {
+         auto const s = 2*l;
+         auto const neg_im = _mm_castsi128_ps(_mm_setr_epi32(0, int(0x80000000), 0, int(0x80000000)));
+         for (std::size_t base = 0; base != 2*n; base += 4*s)
+         {
+            for (std::size_t k = 0; k != l; k += 2)
+            {
+               auto* p = data + base + 2*k;
+               auto const* w1 = tw + 2*k;
+               auto a = _mm_loadu_ps(p);
+               auto b = cmul(_mm_loadu_ps(p + s), _mm_loadu_ps(w1 + s));
+               auto c = cmul(_mm_loadu_ps(p + 2*s), _mm_loadu_ps(w1));
+               auto d = cmul(_mm_loadu_ps(p + 3*s), _mm_loadu_ps(w1 + 2*s));
+
+               auto t0 = _mm_add_ps(a, b);
+               auto t1 = _mm_sub_ps(a, b);
+               auto t2 = _mm_add_ps(c, d);
+               auto t3 = _mm_sub_ps(c, d);
+
+               // -i t3 = (t3i, -t3r)
+               auto u = _mm_xor_ps(_mm_shuffle_ps(t3, t3, _MM_SHUFFLE(2, 3, 0, 1)), neg_im);
+               _mm_storeu_ps(p,       _mm_add_ps(t0, t2));
+               _mm_storeu_ps(p + 2*s, _mm_sub_ps(t0, t2));
+               _mm_storeu_ps(p + s,   _mm_add_ps(t1, u));
+               _mm_storeu_ps(p + 3*s, _mm_sub_ps(t1, u));
+            }
+         }
+      }
+#endif
+
+#if defined(__AVX__)
+      // (a + ib)(c + id) for four complex numbers per register
+      inline __m256 cmul(__m256 z, __m256 w)
+      {
+         auto wr = _mm256_moveldup_ps(w);
+         auto wi = _mm256_movehdup_ps(w);
+         auto zs = _mm256_permute_ps(z, _MM_SHUFFLE(2, 3, 0, 1));
+         return _mm256_addsub_ps(_mm256_mul_ps(z, wr), _mm256_mul_ps(zs, wi));
+      }
+
+      inline void radix4_stage_avx(float* data, std::size_t n, std::size_t l, float const* tw)
+      {
+         auto const s = 2*l;
+         auto const neg_im = _mm256_castsi256_ps(_mm256_setr_epi32(
+            0, int(0x80000000), 0, int(0x80000000), 0, int(0x80000000), 0, int(0x80000000)));
+         for (std::size_t base = 0; base != 2*n; base += 4*s)
+         {
+            for (std::size_t k = 0; k != l; k += 4)
+            {
+               auto* p = data + base + 2*k;
+               auto const* w1 = tw + 2*k;
+               auto a = _mm256_loadu_ps(p);
+               auto b = cmul(_mm256_loadu_ps(p + s), _mm256_loadu_ps(w1 + s));
+               auto c = cmul(_mm256_loadu_ps(p + 2*s), _mm256_loadu_ps(w1));
+               auto d = cmul(_mm256_loadu_ps(p + 3*s), _mm256_loadu_ps(w1 + 2*s));
+
+               auto t0 = _mm256_add_ps(a, b);
+               auto t1 = _mm256_sub_ps(a, b);
+               auto t2 = _mm256_add_ps(c, d);
+               auto t3 = _mm256_sub_ps(c, d);
+
+               auto u = _mm256_xor_ps(_mm256_permute_ps(t3, _MM_SHUFFLE(2, 3, 0, 1)), neg_im);
+               _mm256_storeu_ps(p,       _mm256_add_ps(t0, t2));
+               _mm256_storeu_ps(p + 2*s, _mm256_sub_ps(t0, t2));
+               _mm256_storeu_ps(p + s,   _mm256_add_ps(t1, u));
+               _mm256_storeu_ps(p + 3*s, _mm256_sub_ps(t1, u));
+            }
+         }
+      }
+#endif
+
+      template <std::floating_point T>
+      inline void radix4_stage(T* data, std::size_t n, std::size_t l, T const* tw)
+      {
+         if constexpr (std::is_same_v<T, float>)
+         {
+#if defined(__AVX__)
+            if (l % 4 == 0)
+               return radix4_stage_avx(data, n, l, tw);
+#endif
+#if defined(__SSE3__)
+            if (l % 2 == 0)
+               return radix4_stage_sse(data, n, l, tw);
+#endif
+         }
+         radix4_stage_scalar(data, n, l, tw);
+      }
+   }
+
+   template <std::floating_point T>
+   inline void fft_radix4(T* data, fft_tables<T> const& t)
+   {
+      using namespace fft_radix4_detail;
+      auto const n = t.n;
+      if (n < 2)
+         return;
+
+      permute(data, t);
+
+      std::size_t l = 1;
+      if (t.radix2_first)
+      {
+         radix2_first(data, n);
+         l = 2;
+      }
+
+      auto const* tw = t.twiddles.data();
+      for (; l < n; l *= 4)
+      {
+         radix4_stage(data, n, l, tw);
+         tw += 6*l;
+      }
+   }
+}
+
+#endif
@@ -37,6 +37,18 @@ namespace cycfi::q::detail
          "Error: Storage must have a size that is a power of two");
       _mask = _data.size() - 1;
    }
+
+   // Construct a C (e.g. a ring_buffer or a bitset) given its size when
+   // its storage_type is resizable. A C with fixed size storage is default
+   // constructed, and the size is ignored.
+   template <typename C>
+   C make_sized(std::size_t size)
+   {
+      if constexpr (resizable_container<typename C::storage_type>::value)
+         return C(size);
+      else
+         return C();
+   }
 }
 
 #endif
@@ -0,0 +1,171 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_XOR_COUNT_BITS_HPP_OCTOBER_17_2026)
+#define CYCFI_Q_XOR_COUNT_BITS_HPP_OCTOBER_17_2026
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <q/detail/count_bits.hpp>
+
+#if defined(__AVX2__) || (defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__))
+# include <immintrin.h>
+#endif
+
+namespace cycfi::q::detail
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // xor_count_bits: the inner kernel of bitstream_acf.
+   //
+   // Counts the mismatched bits between n words at p1 and the bitstream at
+   // p2 shifted right by s bits, for each of the nshifts consecutive shifts
+   // s = shift, shift+1, ... and stores each count in out[k]. All shifts in
+   // one call share the same word offset (shift + nshifts <= bits per word),
+   // which is what lets a single pass serve all of them: the words of p1 and
+   // p2 are loaded once and only the funnel shift differs per lag.
+   //
+   // p2 must be readable up to p2[n] (one word past the n compared words),
+   // as the shifted word straddles two adjacent words.
+   //
+   // The vector paths are chosen at compile time from the target ISA:
+   // AVX-512 VPOPCNTDQ (8 words per step, native 64-bit popcount), then AVX2
+   // (4 words per step, nibble-LUT popcount, summed per 64-bit lane with
+   // vpsadbw), then the scalar fallback. Only 64-bit words are vectorized.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T>
+   inline T funnel_shift(T a, T b, std::size_t s)
+   {
+      // (b << (value_size - s)) without the undefined shift by value_size
+      // when s == 0.
+      constexpr auto value_size = CHAR_BIT * sizeof(T);
+      return (a >> s) | ((b << 1) << (value_size - 1 - s));
+   }
+
+   template <typename T>
+   inline std::size_t xor_count_bits_scalar(
+      T const* p1, T const* p2, std::size_t n, std::size_t s)
+   {
+      std::size_t count = 0;
+      for (std::size_t i = 0; i != n; ++i)
+         count += count_bits(p1[i] ^ funnel_shift(p2[i], p2[i+1], s));
+      return count;
+   }
+
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+
+   template <std::size_t... J>
+   inline void xor_count_bits_simd(
+      std::uint64_t const* p1, std::uint64_t const* p2
+    , std::size_t n, std::size_t shift, std::size_t* out
+    , std::index_sequence<J...>)
+   {
+      // One accumulator and one pair of shift counts per lag. The lags are
+      // unrolled with fold expressions (not a loop over J) so that each
+      // accumulator is a distinct register even without -funroll-loops.
+      __m512i acc[] = { (J, _mm512_setzero_si512())... };
+      __m128i const sr[] = { _mm_cvtsi64_si128(shift + J)... };
+      __m128i const sl[] = { _mm_cvtsi64_si128(64 - (shift + J))... };  // 64 shifts out to 0
+
+      std::size_t i = 0;
+      for (; i + 8 <= n; i += 8)
+      {
+         auto x = _mm512_loadu_si512(p1 + i);
+         auto a = _mm512_loadu_si512(p2 + i);
+         auto b = _mm512_loadu_si512(p2 + i + 1);
+         ((acc[J] = _mm512_add_epi64(acc[J], _mm512_popcnt_epi64(_mm512_xor_si512(x
+            , _mm512_or_si512(_mm512_srl_epi64(a, sr[J]), _mm512_sll_epi64(b, sl[J])))))), ...);
+      }
+
+      ((out[J] = _mm512_reduce_add_epi64(acc[J])
+         + xor_count_bits_scalar(p1 + i, p2 + i, n - i, shift + J)), ...);
+   }
+
+#elif defined(__AVX2__)
+
+   inline __m256i popcount_epi64(__m256i v)
+   {
+      // Mula's nibble lookup: pshufb counts the bits of each nibble, and
+      // vpsadbw sums the byte counts into the four 64-bit lanes.
+      auto const lut = _mm256_setr_epi8(
+         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+       , 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+      );
+      auto const low_mask = _mm256_set1_epi8(0x0f);
+      auto lo = _mm256_and_si256(v, low_mask);
+      auto hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+      auto cnt = _mm256_add_epi8(
+         _mm256_shuffle_epi8(lut, lo), _mm256_shuffle_epi8(lut, hi));
+      return _mm256_sad_epu8(cnt, _mm256_setzero_si256());
+   }
+
+   inline std::uint64_t reduce_add_epi64(__m256i v)
+   {
+      auto s = _mm_add_epi64(
+         _mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+      return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+   }
+
+   template <std::size_t... J>
+   inline void xor_count_bits_simd(
+      std::uint64_t const* p1, std::uint64_t const* p2
+    , std::size_t n, std::size_t shift, std::size_t* out
+    , std::index_sequence<J...>)
+   {
+      // One accumulator and one pair of shift counts per lag. The lags are
+      // unrolled with fold expressions (not a loop over J) so that each
+      // accumulator is a distinct register even without -funroll-loops.
+      __m256i acc[] = { (J, _mm256_setzero_si256())... };
+      __m128i const sr[] = { _mm_cvtsi64_si128(shift + J)... };
+      __m128i const sl[] = { _mm_cvtsi64_si128(64 - (shift + J))... };  // 64 shifts out to 0
+
+      std::size_t i = 0;
+      for (; i + 4 <= n; i += 4)
+      {
+         auto x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p1 + i));
+         auto a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p2 + i));
+         auto b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p2 + i + 1));
+         ((acc[J] = _mm256_add_epi64(acc[J], popcount_epi64(_mm256_xor_si256(x
+            , _mm256_or_si256(_mm256_srl_epi64(a, sr[J]), _mm256_sll_epi64(b, sl[J])))))), ...);
+      }
+
+      ((out[J] = reduce_add_epi64(acc[J])
+         + xor_count_bits_scalar(p1 + i, p2 + i, n - i, shift + J)), ...);
+   }
+
+#endif
+
+   template <typename T>
+   inline void xor_count_bits(
+      T const* p1, T const* p2
+    , std::size_t n, std::size_t shift, std::size_t nshifts
+    , std::size_t* out)
+   {
+#if defined(__AVX2__) || (defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__))
+      if constexpr (std::is_same_v<T, std::uint64_t>)
+      {
+         // Four lags at a time keep the accumulators in registers.
+         for (; nshifts >= 4; nshifts -= 4, shift += 4, out += 4)
+            xor_count_bits_simd(p1, p2, n, shift, out, std::make_index_sequence<4>{});
+         switch (nshifts)
+         {
+            case 3: xor_count_bits_simd(p1, p2, n, shift, out, std::make_index_sequence<3>{}); break;
+            case 2: xor_count_bits_simd(p1, p2, n, shift, out, std::make_index_sequence<2>{}); break;
+            case 1: xor_count_bits_simd(p1, p2, n, shift, out, std::make_index_sequence<1>{}); break;
+            default: break;
+         }
+         return;
+      }
+#endif
+      for (std::size_t k = 0; k != nshifts; ++k)
+         out[k] = xor_count_bits_scalar(p1, p2, n, shift + k);
+   }
+}
+
+#endif
@@ -0,0 +1,286 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_BATCH_FFT_OCTOBER_17_2026)
+#define CYCFI_Q_BATCH_FFT_OCTOBER_17_2026
+
+#include <q/fft/fft.hpp>
+#include <algorithm>
+#include <cstddef>
+
+#if defined(__AVX__) || defined(__SSE2__)
+# include <immintrin.h>
+#endif
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // batch_fft: the FFTs of K channels at once.
+   //
+   // The K channels are transposed (channel-interleaved): point i of all
+   // channels is stored together, the K real parts, then the K imaginary
+   // parts:
+   //
+   //    data = [ re(0)[0..K), im(0)[0..K), re(1)[0..K), im(1)[0..K), ... ]
+   //
+   // so an N-point batch of K channels takes 2 x N x K floats, and point i
+   // of channel c is at data[2iK + c] (real) and data[2iK + K + c]
+   // (imaginary).
+   //
+   // The transform is fft<N>'s radix-4 engine (see detail::fft_radix4),
+   // with the same tables, but each butterfly operates on all K channels,
+   // a SIMD lane per channel: as many AVX vectors (8 lanes) as fit in K,
+   // then SSE2 vectors (4 lanes), then scalars for the rest. The control
+   // flow and the twiddle factors are shared by the channels, and the
+   // vectors are full regardless of N, so the cost per channel drops with
+   // the vector width. K is best a multiple of the vector width.
+   //
+   // batch_ifft<N, K> is the inverse, normalized by N, as ifft<N>.
+   // batch_interleave<K> and batch_deinterleave<K> convert K separate real
+   // channels to and from the real parts of the batch layout.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N, std::size_t K>
+   void batch_fft(float* data);
+
+   template <std::size_t N, std::size_t K>
+   void batch_ifft(float* data);
+
+   template <std::size_t K>
+   void batch_interleave(float const* const* channels, std::size_t n, float* data);
+
+   template <std::size_t K>
+   void batch_deinterleave(float const* data, std::size_t n, float* const* channels);
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   namespace detail
+   {
+      // The instruction sets of the batch butterflies: a vector type, its
+      // width in floats, and the few operations the butterflies need.
+      struct batch_scalar
+      {
+         using type = float;
+         static constexpr std::size_t width = 1;
+
+         static type load(float const* p)          { return *p; }
+         static void store(float* p, type v)       { *p = v; }
+         static type set1(float v)                 { return v; }
+         static type add(type a, type b)           { return a + b; }
+         static type sub(type a, type b)           { return a - b; }
+         static type mul(type a, type b)           { return a * b; }
+      };
+
+#if defined(__SSE2__)
+      struct batch_sse
+      {
+         using type = __m128;
+         static constexpr std::size_t width = 4;
+
+         static type load(float const* p)          { return _mm_loadu_ps(p); }
+         static void store(float* p, type v)       { _mm_storeu_ps(p, v); }
+         static type set1(float v)                 { return _mm_set1_ps(v); }
+         static type add(type a, type b)           { return _mm_add_ps(a, b); }
+         static type sub(type a, type b)           { return _mm_sub_ps(a, b); }
+         static type mul(type a, type b)           { return _mm_mul_ps(a, b); }
+      };
+#endif
+
+#if defined(__AVX__)
+      struct batch_avx
+      {
+         using type = __m256;
+         static constexpr std::size_t width = 8;
+
+         static type load(float const* p)          { return _mm256_loadu_ps(p); }
+         static void store(float* p, type v)       { _mm256_storeu_ps(p, v); }
+         static type set1(float v)                 { return _mm256_set1_ps(v); }
+         static type add(type a, type b)           { return _mm256_add_ps(a, b); }
+         static type sub(type a, type b)           { return _mm256_sub_ps(a, b); }
+         static type mul(type a, type b)           { return _mm256_mul_ps(a, b); }
+      };
+#endif
+
+      // Call f(isa, j) for lanes j to j + isa::width, across the K lanes:
+      // the widest vectors first, then narrower ones for the rest.
+      template <std::size_t K, typename F>
+      inline void batch_lanes(F&& f)
+      {
+#if defined(__AVX__)
+         constexpr std::size_t avx_end = K - K % batch_avx::width;
+         for (std::size_t j = 0; j != avx_end; j += batch_avx::width)
+            f(batch_avx{}, j);
+#else
+         constexpr std::size_t avx_end = 0;
+#endif
+#if defined(__SSE2__)
+         constexpr std::size_t sse_end = K - (K - avx_end) % batch_sse::width;
+         for (std::size_t j = avx_end; j != sse_end; j += batch_sse::width)
+            f(batch_sse{}, j);
+#else
+         constexpr std::size_t sse_end = avx_end;
+#endif
+         for (std::size_t j = sse_end; j != K; ++j)
+            f(batch_scalar{}, j);
+      }
+
+      template <std::size_t K>
+      inline void batch_permute(float* data, fft_tables<float> const& t)
+      {
+         auto const* s = t.swaps.data();
+         auto const* end = s + t.swaps.size();
+         for (; s != end; s += 2)
+         {
+            auto* a = data + 2*K*s[0];
+            std::swap_ranges(a, a + 2*K, data + 2*K*s[1]);
+         }
+      }
+
+      template <std::size_t K>
+      inline void batch_radix2_first(float* data, std::size_t n)
+      {
+         for (std::size_t i = 0; i != 2*K*n; i += 4*K)
+         {
+            auto* p = data + i;
+            batch_lanes<2*K>(
+               [p](auto isa, std::size_t j)
+               {
+                  auto a = isa.load(p + j);
+                  auto b = isa.load(p + 2*K + j);
+                  isa.store(p + j, isa.add(a, b));
+                  isa.store(p + 2*K + j, isa.sub(a, b));
+               }
+            );
+         }
+      }
+
+      // The radix-4 stage of fft_radix4, on K lanes. See fft_radix4.hpp
+      // for the butterfly.
+      template <std::size_t K>
+      inline void batch_radix4_stage(float* data, std::size_t n, std::size_t l, float const* tw)
+      {
+         auto const s = 2*K*l;
+         for (std::size_t base = 0; base != 2*K*n; base += 4*s)
+         {
+            for (std::size_t k = 0; k != l; ++k)
+            {
+               auto const* w1 = tw + 2*k;
+               auto const* w2 = w1 + 2*l;
+               auto const* w3 = w1 + 4*l;
+               auto* p = data + base + 2*K*k;
+
+               batch_lanes<K>(
+                  [=](auto isa, std::size_t j)
+                  {
+                     auto w1r = isa.set1(w1[0]), w1i = isa.set1(w1[1]);
+                     auto w2r = isa.set1(w2[0]), w2i = isa.set1(w2[1]);
+                     auto w3r = isa.set1(w3[0]), w3i = isa.set1(w3[1]);
+
+                     auto* pa = p + j;
+                     auto* pb = pa + s;
+                     auto* pc = pb + s;
+                     auto* pd = pc + s;
+
+                     auto ar = isa.load(pa), ai = isa.load(pa + K);
+                     auto xr = isa.load(pb), xi = isa.load(pb + K);
+                     auto br = isa.sub(isa.mul(xr, w2r), isa.mul(xi, w2i));
+                     auto bi = isa.add(isa.mul(xr, w2i), isa.mul(xi, w2r));
+                     xr = isa.load(pc), xi = isa.load(pc + K);
+                     auto cr = isa.sub(isa.mul(xr, w1r), isa.mul(xi, w1i));
+                     auto ci = isa.add(isa.mul(xr, w1i), isa.mul(xi, w1r));
+                     xr = isa.load(pd), xi = isa.load(pd + K);
+                     auto dr = isa.sub(isa.mul(xr, w3r), isa.mul(xi, w3i));
+                     auto di = isa.add(isa.mul(xr, w3i), isa.mul(xi, w3r));
+
+                     auto t0r = isa.add(ar, br), t0i = isa.add(ai, bi);
+                     auto t1r = isa.sub(ar, br), t1i = isa.sub(ai, bi);
+                     auto t2r = isa.add(cr, dr), t2i = isa.add(ci, di);
+                     auto t3r = isa.sub(cr, dr), t3i = isa.sub(ci, di);
+
+                     isa.store(pa, isa.add(t0r, t2r));
+                     isa.store(pa + K, isa.add(t0i, t2i));
+                     isa.store(pc, isa.sub(t0r, t2r));
+                     isa.store(pc + K, isa.sub(t0i, t2i));
+                     isa.store(pb, isa.add(t1r, t3i));
+                     isa.store(pb + K, isa.sub(t1i, t3r));
+                     isa.store(pd, isa.sub(t1r, t3i));
+                     isa.store(pd + K, isa.add(t1i, t3r));
+                  }
+               );
+            }
+         }
+      }
+
+      template <std::size_t K>
+      inline void batch_fft_radix4(float* data, fft_tables<float> const& t)
+      {
+         auto const n = t.n;
+         if (n < 2)
+            return;
+
+         batch_permute<K>(data, t);
+
+         std::size_t l = 1;
+         if (t.radix2_first)
+         {
+            batch_radix2_first<K>(data, n);
+            l = 2;
+         }
+
+         auto const* tw = t.twiddles.data();
+         for (; l < n; l *= 4)
+         {
+            batch_radix4_stage<K>(data, n, l, tw);
+            tw += 6*l;
+         }
+      }
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline void batch_fft(float* data)
+   {
+      static_assert(is_pow2(N), "N must be a power of 2");
+      static_assert(K >= 1, "K must be at least 1");
+      detail::batch_fft_radix4<K>(data, detail::fft_tables_of<float, N>());
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline void batch_ifft(float* data)
+   {
+      // As ifft: reverse bins 1 to N-1, transform forward, and normalize
+      for (std::size_t i = 1; i < N/2; ++i)
+         std::swap_ranges(data + 2*K*i, data + 2*K*(i+1), data + 2*K*(N-i));
+      batch_fft<N, K>(data);
+      detail::ifft_normalize(data, 2*K*N, N);
+   }
+
+   template <std::size_t K>
+   inline void batch_interleave(float const* const* channels, std::size_t n, float* data)
+   {
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         auto* p = data + 2*K*i;
+         for (std::size_t c = 0; c != K; ++c)
+         {
+            p[c] = channels[c][i];
+            p[K + c] = 0.0f;
+         }
+      }
+   }
+
+   template <std::size_t K>
+   inline void batch_deinterleave(float const* data, std::size_t n, float* const* channels)
+   {
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         auto const* p = data + 2*K*i;
+         for (std::size_t c = 0; c != K; ++c)
+            channels[c][i] = p[c];
+      }
+   }
+}
+
+#endif
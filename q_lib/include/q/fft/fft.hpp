@@ -29,9 +29,11 @@
 
 #include <q/support/literals.hpp>
 #include <infra/support.hpp>
+#include <q/detail/fft_radix4.hpp>
 
 #include <utility>
 #include <array>
+#include <cmath>
 #include <concepts>
 
 namespace cycfi::q
@@ -225,16 +227,29 @@ namespace cycfi::q
             j += m;
          }
       }
+
+      // The tables of the N-point FFT, computed on first use and shared by
+      // all subsequent calls (and threads).
+      template <std::floating_point T, std::size_t N>
+      inline fft_tables<T> const& fft_tables_of()
+      {
+         static fft_tables<T> const tables{ N };
+         return tables;
+      }
    }
 
    /**
     * \brief
     *    Performs an in-place Fast Fourier Transform (FFT) on the input data
-    *    array using the Danielson-Lanczos algorithm.
+    *    array.
     *
     *    The input data array is first scrambled to reorder the elements, and
-    *    then the recursive Danielson-Lanczos algorithm is applied to compute
-    *    the FFT.
+    *    then the FFT is computed with radix-4 stages (see detail::fft_radix4),
+    *    using twiddle factors and a bit-reversal table computed on the first
+    *    call for each N and T. The first call is therefore not real-time
+    *    safe: call it once at setup to prime the tables. Define
+    *    Q_USE_DANIELSON_LANCZOS_FFT to use the recursive Danielson-Lanczos
+    *    algorithm instead, with no tables.
     *
     * \tparam N
     *    The size of the input data array. Must be a power of 2.
@@ -253,9 +268,41 @@ namespace cycfi::q
    template <std::size_t N, std::floating_point T>
    inline void fft(T* data)
    {
+      static_assert(is_pow2(N), "N must be a power of 2");
+#if defined(Q_USE_DANIELSON_LANCZOS_FFT)
       detail::danielson_lanczos<T, N> recursion;
       detail::scramble<T, N>(data);
       recursion.apply(data);
+#else
+      detail::fft_radix4(data, detail::fft_tables_of<T, N>());
+#endif
+   }
+
+   namespace detail
+   {
+      // The first step of the inverse: the spectrum, with bins 1 to n-1
+      // reversed, transforms forward into the (unscaled) inverse.
+      template <std::floating_point T>
+      inline void ifft_reverse(T* data, std::size_t n)
+      {
+         auto const _2n = n*2;
+         // Swap the real and imaginary parts of the i-th and (N-i)-th
+         // complex numbers.
+         for (std::size_t i = 1; i < n/2; ++i)
+         {
+            auto _2i = 2*i;
+            std::swap(data[2*i], data[_2n-_2i]);
+            std::swap(data[2*i+1], data[(_2n+1)-_2i]);
+         }
+      }
+
+      // Normalize the data by dividing each of its size elements by n.
+      template <std::floating_point T>
+      inline void ifft_normalize(T* data, std::size_t size, std::size_t n)
+      {
+         for (std::size_t i = 0; i < size; ++i)
+            data[i] /= n;
+      }
    }
 
    /**
@@ -285,30 +332,255 @@ namespace cycfi::q
    template <std::size_t N, std::floating_point T>
    inline void ifft(T* data)
    {
-      constexpr std::size_t _2n = N*2;
-      // Swap the real and imaginary parts of the i-th and (N-i)-th complex
-      // numbers.
-      for (auto i = 1; i < N/2; ++i)
-      {
-         auto _2i = 2*i;
-         std::swap(data[2*i], data[_2n-_2i]);
-         std::swap(data[2*i+1], data[(_2n+1)-_2i]);
-      }
+      detail::ifft_reverse(data, N);
       // Perform FFT in-situ
       fft<N>(data);
-      // Normalize the data by dividing each element by N.
-      for (auto i = 0; i < 2*N; ++i)
-         data[i] /= N;
+      detail::ifft_normalize(data, 2*N, N);
+   }
+
+   namespace detail
+   {
+      // The twiddle factor step of an n-point real transform: w = exp(-i
+      // 2pi/n) is reached from w(k-1) by the same trigonometric recurrence
+      // as danielson_lanczos, computed in double for accuracy. rfft_twiddle
+      // is constructed from sin(pi/n) and sin(2pi/n): rfft_twiddle_of<N>()
+      // computes these at compile time, rfft_twiddle_of(n) at run time.
+      struct rfft_twiddle
+      {
+         constexpr rfft_twiddle(double sin_half, double sin_full)
+          : wpr{ -2.0 * sin_half * sin_half }
+          , wpi{ -sin_full }
+         {}
+
+         void next()
+         {
+            double t = wr;
+            wr += wr * wpr - wi * wpi;
+            wi += wi * wpr + t * wpi;
+         }
+
+         double wpr;
+         double wpi;
+         double wr = 1.0;
+         double wi = 0.0;
+      };
+
+      template <std::size_t N>
+      constexpr rfft_twiddle rfft_twiddle_of()
+      {
+         return { sin<double, N, 1>(), sin<double, N, 2>() };
+      }
+
+      inline rfft_twiddle rfft_twiddle_of(std::size_t n)
+      {
+         return { std::sin(pi / n), std::sin(2 * pi / n) };
+      }
+
+      // The split step of rfft, after the n/2-point fft of the n real
+      // samples packed as n/2 complex points.
+      template <std::floating_point T>
+      inline void rfft_split(T* data, std::size_t n, rfft_twiddle w)
+      {
+         auto const m = n/2;
+
+         // Bins 0 and N/2: the sum and difference of Z(0)'s parts
+         T z0r = data[0];
+         T z0i = data[1];
+         data[0] = z0r + z0i;
+         data[1] = z0r - z0i;
+
+         // Bins k and M-k, together. With Z(k) the N/2-point transform:
+         //
+         //    E = (Z(k) + conj(Z(M-k))) / 2      (the even samples' spectrum)
+         //    O = (Z(k) - conj(Z(M-k))) / 2i     (the odd samples' spectrum)
+         //    X(k) = E + w(k) O,  X(M-k) = conj(E - w(k) O)
+         for (std::size_t k = 1; k < m-k; ++k)
+         {
+            w.next();
+            auto* a = data + 2*k;
+            auto* b = data + 2*(m-k);
+            T er = (a[0] + b[0]) * T(0.5);
+            T ei = (a[1] - b[1]) * T(0.5);
+            T or_ = (a[1] + b[1]) * T(0.5);
+            T oi = (b[0] - a[0]) * T(0.5);
+            T tr = T(w.wr) * or_ - T(w.wi) * oi;
+            T ti = T(w.wr) * oi + T(w.wi) * or_;
+            a[0] = er + tr;
+            a[1] = ei + ti;
+            b[0] = er - tr;
+            b[1] = ti - ei;
+         }
+
+         // Bin N/4 (k = M-k) is conj(Z(N/4))
+         if (m >= 2)
+            data[m+1] = -data[m+1];
+      }
+
+      // The reverse of rfft_split, before the n/2-point ifft.
+      template <std::floating_point T>
+      inline void irfft_merge(T* data, std::size_t n, rfft_twiddle w)
+      {
+         auto const m = n/2;
+
+         T x0 = data[0];
+         T xm = data[1];
+         data[0] = (x0 + xm) * T(0.5);
+         data[1] = (x0 - xm) * T(0.5);
+
+         // The reverse of rfft's step:
+         //
+         //    E = (X(k) + conj(X(M-k))) / 2
+         //    O = (X(k) - conj(X(M-k))) conj(w(k)) / 2
+         //    Z(k) = E + i O,  Z(M-k) = conj(E) + i conj(O)
+         for (std::size_t k = 1; k < m-k; ++k)
+         {
+            w.next();
+            auto* a = data + 2*k;
+            auto* b = data + 2*(m-k);
+            T er = (a[0] + b[0]) * T(0.5);
+            T ei = (a[1] - b[1]) * T(0.5);
+            T dr = (a[0] - b[0]) * T(0.5);
+            T di = (a[1] + b[1]) * T(0.5);
+            T or_ = T(w.wr) * dr + T(w.wi) * di;
+            T oi = T(w.wr) * di - T(w.wi) * dr;
+            a[0] = er - oi;
+            a[1] = ei + or_;
+            b[0] = er + oi;
+            b[1] = or_ - ei;
+         }
+
+         if (m >= 2)
+            data[m+1] = -data[m+1];
+      }
+
+      // The magnitudes of rfft's packed spectrum of n real samples, into
+      // its leading n/2+1 elements.
+      template <std::floating_point T>
+      inline void rfft_magnitudes(T* data, std::size_t n)
+      {
+         // Compacting bin k, at data[2k] and data[2k+1], into data[k] in
+         // ascending order is overwrite-safe, except for the Nyquist bin in
+         // data[1], which is saved first.
+         T nyquist = data[1];
+         data[0] = std::abs(data[0]);
+         for (std::size_t k = 1; k < n/2; ++k)
+            data[k] = std::hypot(data[2*k], data[2*k+1]);
+         data[n/2] = std::abs(nyquist);
+      }
+
+      // Gather the real parts of n interleaved complex numbers into the
+      // leading n elements. Gathering data[2i] into data[i] in ascending
+      // order is overwrite-safe: iteration i reads index 2i >= i.
+      template <std::floating_point T>
+      inline void gather_real(T* data, std::size_t n)
+      {
+         for (std::size_t i = 1; i < n; ++i)
+            data[i] = data[2*i];
+      }
+   }
+
+   /**
+    * \brief
+    *    Performs an in-place Fast Fourier Transform (FFT) of N real
+    *    samples.
+    *
+    *    The samples are taken as N/2 complex points (even samples in the
+    *    real parts, odd samples in the imaginary parts) and transformed
+    *    with an N/2-point fft. The spectra of the even and odd samples
+    *    are then separated and combined into the spectrum of the N real
+    *    samples. This is about half the work of an N-point complex fft
+    *    of the same samples, with no imaginary parts to zero, and needs
+    *    no more than N scalars.
+    *
+    * \tparam N
+    *    The number of real samples. Must be a power of 2, at least 2.
+    *
+    * \tparam T
+    *    The floating-point type of the input data (e.g., float, double).
+    *
+    * \param data
+    *    A pointer to the N real samples.
+    *
+    * \note
+    *    The spectrum of a real signal is conjugate-symmetric, so bins 0
+    *    to N/2 hold all of it, and bins 0 (DC) and N/2 (Nyquist) are
+    *    real. On return, data[0] is the DC bin, data[1] is the Nyquist
+    *    bin, and bin k (0 < k < N/2) is at data[2k] (real) and
+    *    data[2k+1] (imaginary). As with fft, no scaling is applied.
+   */
+   template <std::size_t N, std::floating_point T>
+   inline void rfft(T* data)
+   {
+      static_assert(N >= 2 && is_pow2(N), "N must be a power of 2, at least 2");
+      fft<N/2>(data);
+      detail::rfft_split(data, N, detail::rfft_twiddle_of<N>());
+   }
+
+   /**
+    * \brief
+    *    Performs an in-place Inverse Fast Fourier Transform (IFFT) of the
+    *    spectrum of N real samples.
+    *
+    *    The inverse of rfft: the spectrum, in rfft's layout, is folded
+    *    back into the spectrum of N/2 complex points, transformed with an
+    *    N/2-point ifft, giving the even samples in the real parts and the
+    *    odd samples in the imaginary parts, which is the original layout.
+    *
+    * \tparam N
+    *    The number of real samples. Must be a power of 2, at least 2.
+    *
+    * \tparam T
+    *    The floating-point type of the input data (e.g., float, double).
+    *
+    * \param data
+    *    A pointer to the spectrum, N scalars in rfft's layout.
+    *
+    * \note
+    *    As with ifft, the result is normalized, so that
+    *    irfft<N>(rfft<N>(x)) == x.
+   */
+   template <std::size_t N, std::floating_point T>
+   inline void irfft(T* data)
+   {
+      static_assert(N >= 2 && is_pow2(N), "N must be a power of 2, at least 2");
+      detail::irfft_merge(data, N, detail::rfft_twiddle_of<N>());
+      ifft<N/2>(data);
+   }
+
+   /**
+    * \brief
+    *    Computes the magnitude spectrum of N real samples using rfft.
+    *
+    * \tparam N
+    *    The number of real samples. Must be a power of 2.
+    *
+    * \tparam T
+    *    The floating-point type of the input data (e.g., float, double).
+    *
+    * \param data
+    *    A pointer to the N real samples.
+    *
+    * \note
+    *    The input data array is modified in place. After the function
+    *    returns, the leading N/2+1 elements hold the magnitude spectrum
+    *    (DC through Nyquist).
+   */
+   template <std::size_t N, std::floating_point T>
+   inline void rmagspec(T* data)
+   {
+      rfft<N>(data);
+      detail::rfft_magnitudes(data, N);
    }
 
    /**
     * \brief
     *    Computes the magnitude spectrum of a given data array using FFT.
     *
-    *    This function performs an in-place Fast Fourier Transform (FFT) on
-    *    the input data array and then computes the magnitude spectrum. The
-    *    magnitude spectrum represents the amplitude of each frequency
-    *    component in the input data.
+    *    The data array holds N complex points, interleaved, as in fft, of
+    *    which only the real parts are used: the magnitude spectrum is that
+    *    of a real signal. The real parts are gathered into the leading N
+    *    elements and transformed with rfft (see rmagspec), which is about
+    *    half the work of the N-point complex fft.
     *
     * \tparam N
     *    The size of the input data array. Must be a power of 2.
@@ -317,7 +589,7 @@ namespace cycfi::q
     *    The floating-point type of the input data (e.g., float, double).
     *
     * \param data
-    *    A pointer to the input data array. The array must have at least N
+    *    A pointer to the input data array. The array must have at least 2N
     *    elements.
     *
     * \note
@@ -328,16 +600,8 @@ namespace cycfi::q
    template <std::size_t N, std::floating_point T>
    inline void magspec(T* data)
    {
-      // Perform FFT in place
-      fft<N>(data);
-
-      // Compute the magnitude of each bin from DC through Nyquist. `fft`
-      // stores bin k interleaved: real at data[2k], imaginary at data[2k+1].
-      // Compacting into data[0..N/2] in ascending order is overwrite-safe:
-      // iteration k reads indices >= 2k and writes index k, and every later
-      // read starts at 2(k+1) = 2k+2 > k.
-      for (std::size_t k = 0; k <= N/2; ++k)
-         data[k] = std::hypot(data[2*k], data[2*k+1]);
+      detail::gather_real(data, N);
+      rmagspec<N>(data);
    }
 }
 
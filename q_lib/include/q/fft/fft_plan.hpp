@@ -0,0 +1,141 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_FFT_PLAN_OCTOBER_17_2026)
+#define CYCFI_Q_FFT_PLAN_OCTOBER_17_2026
+
+#include <q/fft/fft.hpp>
+#include <memory>
+#include <stdexcept>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // basic_fft_plan: the FFTs of fft.hpp, for a size known only at run time.
+   //
+   // fft<N>, ifft<N>, rfft<N>, irfft<N>, rmagspec<N> and magspec<N> take N
+   // as a template parameter. A plan is constructed for a size n, a power
+   // of two, chosen at run time (e.g. from the sample rate and the lowest
+   // frequency), and provides the same transforms, with the same data
+   // layouts and results, as member functions:
+   //
+   //    fft(data), ifft(data), magspec(data)
+   //                            n complex points, 2n scalars, interleaved
+   //    rfft(data), irfft(data), rmagspec(data)
+   //                            n real samples, n scalars
+   //
+   // The plan computes its tables (the bit-reversal permutation and the
+   // twiddle factors of the n-point and n/2-point transforms) once, at
+   // construction, which is the only allocation. The transforms are in
+   // place and need no scratch memory, so they are const and allocation
+   // free: a plan can be shared read-only between threads. The tables are
+   // immutable and reference counted, so copying a plan is cheap and the
+   // copies share them.
+   //
+   // The plan always uses the radix-4 engine (detail::fft_radix4), even
+   // where Q_USE_DANIELSON_LANCZOS_FFT is defined.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::floating_point T>
+   class basic_fft_plan
+   {
+   public:
+
+      explicit                basic_fft_plan(std::size_t n);
+
+      std::size_t             size() const         { return _tables->n; }
+
+      void                    fft(T* data) const;
+      void                    ifft(T* data) const;
+      void                    magspec(T* data) const;
+
+      void                    rfft(T* data) const;
+      void                    irfft(T* data) const;
+      void                    rmagspec(T* data) const;
+
+   private:
+
+      using tables_ptr = std::shared_ptr<detail::fft_tables<T> const>;
+
+      tables_ptr              _tables;       // n points: fft, ifft
+      tables_ptr              _half_tables;  // n/2 points: rfft, irfft
+      detail::rfft_twiddle    _twiddle;
+   };
+
+   using fft_plan = basic_fft_plan<float>;
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   namespace detail
+   {
+      // Validates the size before any of the tables are built
+      inline std::size_t fft_plan_check(std::size_t n)
+      {
+#if __cpp_exceptions == 199711
+         if (n < 2 || !is_pow2(n))
+            throw std::runtime_error(
+               "Error: fft_plan size must be a power of 2, at least 2."
+            );
+#endif
+         return n;
+      }
+   }
+
+   template <std::floating_point T>
+   inline basic_fft_plan<T>::basic_fft_plan(std::size_t n)
+    : _tables{ std::make_shared<detail::fft_tables<T> const>(detail::fft_plan_check(n)) }
+    , _half_tables{ std::make_shared<detail::fft_tables<T> const>(n / 2) }
+    , _twiddle{ detail::rfft_twiddle_of(n) }
+   {}
+
+   template <std::floating_point T>
+   inline void basic_fft_plan<T>::fft(T* data) const
+   {
+      detail::fft_radix4(data, *_tables);
+   }
+
+   template <std::floating_point T>
+   inline void basic_fft_plan<T>::ifft(T* data) const
+   {
+      auto const n = size();
+      detail::ifft_reverse(data, n);
+      detail::fft_radix4(data, *_tables);
+      detail::ifft_normalize(data, 2*n, n);
+   }
+
+   template <std::floating_point T>
+   inline void basic_fft_plan<T>::magspec(T* data) const
+   {
+      detail::gather_real(data, size());
+      rmagspec(data);
+   }
+
+   template <std::floating_point T>
+   inline void basic_fft_plan<T>::rfft(T* data) const
+   {
+      detail::fft_radix4(data, *_half_tables);
+      detail::rfft_split(data, size(), _twiddle);
+   }
+
+   template <std::floating_point T>
+   inline void basic_fft_plan<T>::irfft(T* data) const
+   {
+      auto const m = size() / 2;
+      detail::irfft_merge(data, size(), _twiddle);
+      detail::ifft_reverse(data, m);
+      detail::fft_radix4(data, *_half_tables);
+      detail::ifft_normalize(data, 2*m, m);
+   }
+
+   template <std::floating_point T>
+   inline void basic_fft_plan<T>::rmagspec(T* data) const
+   {
+      rfft(data);
+      detail::rfft_magnitudes(data, size());
+   }
+}
+
+#endif
@@ -0,0 +1,381 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_PARTITIONED_CONVOLVER_OCTOBER_17_2026)
+#define CYCFI_Q_PARTITIONED_CONVOLVER_OCTOBER_17_2026
+
+#include <q/fft/fft_plan.hpp>
+#include <q/fx/fir.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__SSE2__)
+# include <immintrin.h>
+#endif
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // partitioned_convolver: convolution with a long impulse response (IR),
+   // e.g. a cabinet or a reverb, by uniformly partitioned FFT convolution
+   // (overlap-save).
+   //
+   // The IR is split into partitions of block_size samples, each kept as
+   // the rfft spectrum of a 2 x block_size frame (the partition, zero
+   // padded). Every block_size input samples, the spectrum of the last 2 x
+   // block_size samples goes into a frequency-domain delay line (FDL), and
+   // the output block is the second half of the irfft of:
+   //
+   //    sum(p < partitions) X(i - p) H(p)
+   //
+   // where X(i - p) is the input spectrum p blocks ago, and H(p) the
+   // spectrum of partition p. Per block, that is one rfft, one irfft, and a
+   // complex multiply-add per bin per partition, instead of block_size x
+   // ir_size multiply-adds for the direct form. The spectra are stored
+   // split (the real parts, then the imaginary parts), so that the
+   // multiply-add, the bulk of the work for long IRs, runs 4 bins per step
+   // with SSE.
+   //
+   // The input is taken in blocks of any size, and the output is delayed by
+   // latency() = block_size samples: the time to fill a block. Choose the
+   // host's buffer size as the block size. See zero_latency_convolver for
+   // no delay.
+   //
+   // All buffers are allocated at construction.
+   ////////////////////////////////////////////////////////////////////////////
+   class partitioned_convolver
+   {
+   public:
+
+                              partitioned_convolver(
+                                 float const* ir
+                               , std::size_t ir_size
+                               , std::size_t block_size
+                              );
+
+      float                   operator()(float s);
+      void                    process(float const* in, float* out, std::size_t n);
+
+      std::size_t             block_size() const      { return _block_size; }
+      std::size_t             partitions() const      { return _partitions; }
+      std::size_t             latency() const         { return _block_size; }
+      void                    reset();
+
+   private:
+
+      void                    convolve();
+      void                    split(float* data);
+      void                    interleave(float* data);
+
+      std::size_t             _block_size;
+      std::size_t             _partitions;
+      fft_plan                _plan;
+      std::vector<float>      _ir;        // the partitions' spectra
+      std::vector<float>      _fdl;       // the input spectra
+      std::size_t             _head = 0;  // the latest input spectrum
+      std::vector<float>      _frame;     // the last 2 x block_size inputs
+      std::vector<float>      _acc;
+      std::vector<float>      _scratch;
+      std::vector<float>      _out;       // the output block
+      std::size_t             _fill = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // zero_latency_convolver: the non-uniformly partitioned form of
+   // partitioned_convolver, for long IRs with no delay.
+   //
+   // The IR is split into a head and a series of segments, in the manner of
+   // Gardner's scheme:
+   //
+   //    - The head, the first head_size samples, is convolved directly
+   //      (time domain), with no delay, by a fir filter.
+   //
+   //    - Segment k is convolved by a partitioned_convolver with a block
+   //      size of B(k) = head_size x 4^k, and starts at B(k) in the IR,
+   //      so that its latency, B(k), is the segment's own offset in the IR,
+   //      and the sum is aligned. Each segment but the last has 3
+   //      partitions, which ends it at B(k+1), where the next starts.
+   //
+   //    - The block size stops growing at max_block_size, and the last
+   //      segment takes the rest of the IR.
+   //
+   // Small partitions at the head keep the latency at zero, and large
+   // partitions at the tail keep the cost per sample low for multi-second
+   // IRs. The segments compute in the audio thread: a segment with a large
+   // block does its work once per block, so the cost per call is not
+   // uniform. Size the callback's budget for the worst case, when all the
+   // segments complete a block at once.
+   ////////////////////////////////////////////////////////////////////////////
+   class zero_latency_convolver
+   {
+   public:
+
+      static constexpr std::size_t default_head_size = 64;
+      static constexpr std::size_t default_max_block_size = 4096;
+
+                              zero_latency_convolver(
+                                 float const* ir
+                               , std::size_t ir_size
+                               , std::size_t head_size = default_head_size
+                               , std::size_t max_block_size = default_max_block_size
+                              );
+
+      float                   operator()(float s);
+      void                    process(float const* in, float* out, std::size_t n);
+
+      std::size_t             latency() const         { return 0; }
+      std::size_t             segments() const        { return _segments.size(); }
+      void                    reset();
+
+   private:
+
+      fir<float>              _head;
+      std::vector<partitioned_convolver> _segments;
+      std::vector<float>      _scratch;
+      std::vector<float>      _sum;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   namespace detail
+   {
+      // acc += x h, for the n bins of split spectra, where bin 0 holds the
+      // (real) DC and Nyquist bins in its real and imaginary parts. The
+      // SSE path takes 4 bins per step; bin 0 is corrected after.
+      inline void spectrum_mac(
+         float* acc_re, float* acc_im
+       , float const* x_re, float const* x_im
+       , float const* h_re, float const* h_im
+       , std::size_t n
+      )
+      {
+         float const dc = acc_re[0] + x_re[0] * h_re[0];
+         float const nyquist = acc_im[0] + x_im[0] * h_im[0];
+
+         std::size_t k = 0;
+#if defined(__SSE2__)
+         for (; k + 4 <= n; k += 4)
+         {
+            auto xr = _mm_loadu_ps(x_re + k);
+            auto xi = _mm_loadu_ps(x_im + k);
+            auto hr = _mm_loadu_ps(h_re + k);
+            auto hi = _mm_loadu_ps(h_im + k);
+            auto re = _mm_sub_ps(_mm_mul_ps(xr, hr), _mm_mul_ps(xi, hi));
+            auto im = _mm_add_ps(_mm_mul_ps(xr, hi), _mm_mul_ps(xi, hr));
+            _mm_storeu_ps(acc_re + k, _mm_add_ps(_mm_loadu_ps(acc_re + k), re));
+            _mm_storeu_ps(acc_im + k, _mm_add_ps(_mm_loadu_ps(acc_im + k), im));
+         }
+#endif
+         for (; k != n; ++k)
+         {
+            acc_re[k] += x_re[k] * h_re[k] - x_im[k] * h_im[k];
+            acc_im[k] += x_re[k] * h_im[k] + x_im[k] * h_re[k];
+         }
+
+         acc_re[0] = dc;
+         acc_im[0] = nyquist;
+      }
+
+      // The first head_size samples of the IR, zero padded
+      inline std::vector<float> convolver_head(
+         float const* ir, std::size_t ir_size, std::size_t head_size)
+      {
+         std::vector<float> head(head_size, 0.0f);
+         std::copy(ir, ir + std::min(ir_size, head_size), head.begin());
+         return head;
+      }
+   }
+
+   inline partitioned_convolver::partitioned_convolver(
+      float const* ir
+    , std::size_t ir_size
+    , std::size_t block_size
+   )
+    : _block_size(block_size)
+    , _partitions(std::max<std::size_t>((ir_size + block_size - 1) / block_size, 1))
+    , _plan(block_size * 2)
+    , _ir(_partitions * block_size * 2, 0.0f)
+    , _fdl(_partitions * block_size * 2, 0.0f)
+    , _frame(block_size * 2, 0.0f)
+    , _acc(block_size * 2)
+    , _scratch(block_size * 2)
+    , _out(block_size, 0.0f)
+   {
+      auto const n = block_size * 2;
+      for (std::size_t p = 0; p != _partitions; ++p)
+      {
+         auto* h = _ir.data() + p * n;
+         auto first = p * block_size;
+         auto last = std::min(first + block_size, ir_size);
+         if (first < last)
+            std::copy(ir + first, ir + last, h);
+         _plan.rfft(h);
+         split(h);
+      }
+   }
+
+   inline void partitioned_convolver::reset()
+   {
+      std::fill(_fdl.begin(), _fdl.end(), 0.0f);
+      std::fill(_frame.begin(), _frame.end(), 0.0f);
+      std::fill(_out.begin(), _out.end(), 0.0f);
+      _head = 0;
+      _fill = 0;
+   }
+
+   // rfft's packed spectrum, bin k at data[2k] and data[2k+1], to the split
+   // layout, with bin k at data[k] and data[B + k]. The DC and Nyquist
+   // bins, data[0] and data[1], go to data[0] and data[B].
+   inline void partitioned_convolver::split(float* data)
+   {
+      auto const b = _block_size;
+      for (std::size_t k = 0; k != b; ++k)
+      {
+         _scratch[k] = data[2*k];
+         _scratch[b + k] = data[2*k+1];
+      }
+      std::copy(_scratch.begin(), _scratch.end(), data);
+   }
+
+   inline void partitioned_convolver::interleave(float* data)
+   {
+      auto const b = _block_size;
+      for (std::size_t k = 0; k != b; ++k)
+      {
+         _scratch[2*k] = data[k];
+         _scratch[2*k+1] = data[b + k];
+      }
+      std::copy(_scratch.begin(), _scratch.end(), data);
+   }
+
+   inline void partitioned_convolver::convolve()
+   {
+      auto const b = _block_size;
+      auto const n = b * 2;
+
+      // The latest input spectrum, into the FDL
+      auto* x = _fdl.data() + _head * n;
+      std::copy(_frame.begin(), _frame.end(), x);
+      _plan.rfft(x);
+      split(x);
+
+      // Multiply-add the spectra. The DC and Nyquist bins (at 0 and B) are
+      // real, the rest complex.
+      std::fill(_acc.begin(), _acc.end(), 0.0f);
+      auto* acc_re = _acc.data();
+      auto* acc_im = acc_re + b;
+      auto fdl_index = _head;
+      for (std::size_t p = 0; p != _partitions; ++p)
+      {
+         auto const* x_re = _fdl.data() + fdl_index * n;
+         auto const* x_im = x_re + b;
+         auto const* h_re = _ir.data() + p * n;
+         auto const* h_im = h_re + b;
+
+         detail::spectrum_mac(acc_re, acc_im, x_re, x_im, h_re, h_im, b);
+         fdl_index = (fdl_index == 0)? _partitions - 1 : fdl_index - 1;
+      }
+      interleave(_acc.data());
+      _plan.irfft(_acc.data());
+
+      // Overlap-save: the second half is the output block
+      std::copy(_acc.begin() + b, _acc.end(), _out.begin());
+
+      // Slide the frame, and the FDL
+      std::copy(_frame.begin() + b, _frame.end(), _frame.begin());
+      _head = (_head + 1 == _partitions)? 0 : _head + 1;
+   }
+
+   inline void partitioned_convolver::process(float const* in, float* out, std::size_t n)
+   {
+      while (n)
+      {
+         auto m = std::min(n, _block_size - _fill);
+         std::copy(in, in + m, _frame.begin() + _block_size + _fill);
+         std::copy(_out.begin() + _fill, _out.begin() + _fill + m, out);
+         _fill += m;
+         in += m;
+         out += m;
+         n -= m;
+
+         if (_fill == _block_size)
+         {
+            convolve();
+            _fill = 0;
+         }
+      }
+   }
+
+   inline float partitioned_convolver::operator()(float s)
+   {
+      float out;
+      process(&s, &out, 1);
+      return out;
+   }
+
+   inline zero_latency_convolver::zero_latency_convolver(
+      float const* ir
+    , std::size_t ir_size
+    , std::size_t head_size
+    , std::size_t max_block_size
+   )
+    : _head(detail::convolver_head(ir, ir_size, head_size))
+   {
+      auto block_size = head_size;
+      auto first = head_size;
+      while (first < ir_size)
+      {
+         bool last = block_size >= max_block_size;
+         auto size = last? ir_size - first : std::min(ir_size - first, 3 * block_size);
+         _segments.emplace_back(ir + first, size, block_size);
+         first += size;
+         block_size *= 4;
+      }
+      _scratch.resize(std::max(head_size, max_block_size));
+      _sum.resize(_scratch.size());
+   }
+
+   inline void zero_latency_convolver::reset()
+   {
+      _head.reset();
+      for (auto& seg : _segments)
+         seg.reset();
+   }
+
+   inline void zero_latency_convolver::process(float const* in, float* out, std::size_t n)
+   {
+      while (n)
+      {
+         // The segments first, then the head, so that in and out may be
+         // the same.
+         auto m = std::min(n, _scratch.size());
+         std::fill(_sum.begin(), _sum.begin() + m, 0.0f);
+         for (auto& seg : _segments)
+         {
+            seg.process(in, _scratch.data(), m);
+            for (std::size_t i = 0; i != m; ++i)
+               _sum[i] += _scratch[i];
+         }
+         _head.process(in, out, m);
+         for (std::size_t i = 0; i != m; ++i)
+            out[i] += _sum[i];
+         in += m;
+         out += m;
+         n -= m;
+      }
+   }
+
+   inline float zero_latency_convolver::operator()(float s)
+   {
+      float out;
+      process(&s, &out, 1);
+      return out;
+   }
+}
+
+#endif
@@ -0,0 +1,230 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_STFT_OCTOBER_17_2026)
+#define CYCFI_Q_STFT_OCTOBER_17_2026
+
+#include <q/fft/fft_plan.hpp>
+#include <q/support/base.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // stft: a streaming short-time Fourier transform, with optional
+   // overlap-add resynthesis.
+   //
+   // The input is taken in blocks of any size. Every hop samples, the last
+   // size samples (the frame) are multiplied by the window and transformed
+   // with rfft, and the spectral callback is called with the spectrum, in
+   // rfft's packed layout (see fft.hpp): data[0] is the DC bin, data[1] the
+   // Nyquist bin, and bin k (0 < k < size/2) is at data[2k] (real) and
+   // data[2k+1] (imaginary). The callback may modify the spectrum.
+   //
+   // For analysis only, call analyze(in, n, f). For resynthesis, call
+   // process(in, out, n, f): the (modified) spectrum is transformed back
+   // with irfft, multiplied by the window again, and overlap-added into the
+   // output, normalized by the sum of the squared windows that overlap at
+   // each position (the least-squares overlap-add of Griffin and Lim). An
+   // unmodified spectrum reconstructs the input exactly, delayed by
+   // latency() = size - 1 samples, for any window and any hop where the
+   // windows cover every position. The usual choice, the default, is the
+   // periodic Hann window with hop = size/4.
+   //
+   // The window is tabulated at construction, from hann or from a given
+   // function of the index (0 to size-1) and the size. All buffers are
+   // allocated at construction: analyze and process do not allocate.
+   //
+   // The callback is called as f(data), with data a float* to the size
+   // scalars of the spectrum. It is called in the audio thread, at most
+   // once per hop samples.
+   ////////////////////////////////////////////////////////////////////////////
+   class stft
+   {
+   public:
+
+                              stft(std::size_t size, std::size_t hop);
+
+                              template <typename W>
+                              stft(std::size_t size, std::size_t hop, W&& window);
+
+      template <typename F>
+      void                    analyze(float const* in, std::size_t n, F&& f);
+
+      template <typename F>
+      void                    process(float const* in, float* out, std::size_t n, F&& f);
+
+      std::size_t             size() const            { return _plan.size(); }
+      std::size_t             hop() const             { return _hop; }
+      std::size_t             latency() const         { return size() - 1; }
+      float const*            window() const          { return _window.data(); }
+      void                    reset();
+
+      static float            hann(std::size_t i, std::size_t size);
+
+   private:
+
+      template <bool Synthesis, typename F>
+      void                    run(float const* in, float* out, std::size_t n, F&& f);
+
+      template <bool Synthesis, typename F>
+      void                    frame(F&& f);
+
+      fft_plan                _plan;
+      std::size_t             _hop;
+      std::size_t             _fill;
+      std::vector<float>      _window;
+      std::vector<float>      _norm;      // 1 / sum of squared windows, per hop position
+      std::vector<float>      _in;        // the frame
+      std::vector<float>      _data;      // the spectrum
+      std::vector<float>      _acc;       // overlap-add accumulator
+      std::vector<float>      _ready;     // the hop samples ready for output
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   inline float stft::hann(std::size_t i, std::size_t size)
+   {
+      // The periodic Hann window: one period of the raised cosine spans the
+      // size samples, so overlapping windows sum to a constant.
+      return 0.5f * (1.0f - std::cos(2 * pi * i / size));
+   }
+
+   inline stft::stft(std::size_t size, std::size_t hop)
+    : stft(size, hop, &stft::hann)
+   {
+   }
+
+   namespace detail
+   {
+      // Validates the hop before the buffers sized by it are allocated
+      inline std::size_t stft_check(std::size_t size, std::size_t hop)
+      {
+#if __cpp_exceptions == 199711
+         if (hop == 0 || hop > size)
+            throw std::runtime_error(
+               "Error: stft hop must be between 1 and size."
+            );
+#endif
+         return hop;
+      }
+   }
+
+   template <typename W>
+   inline stft::stft(std::size_t size, std::size_t hop, W&& window)
+    : _plan(size)
+    , _hop(detail::stft_check(size, hop))
+    , _fill(size - _hop)
+    , _window(size)
+    , _norm(_hop, 0.0f)
+    , _in(size, 0.0f)
+    , _data(size)
+    , _acc(size, 0.0f)
+    , _ready(_hop, 0.0f)
+   {
+      for (std::size_t i = 0; i != size; ++i)
+         _window[i] = window(i, size);
+
+      // Position j of an output hop overlaps positions j, j + hop, j + 2
+      // hop... of the windows. Where none of them cover it (e.g. a Hann
+      // window's zero at position 0 with hop == size), the output is 0.
+      for (std::size_t j = 0; j != hop; ++j)
+      {
+         double sum = 0;
+         for (auto i = j; i < size; i += hop)
+            sum += double(_window[i]) * _window[i];
+         _norm[j] = (sum > 1e-9)? float(1.0 / sum) : 0.0f;
+      }
+   }
+
+   inline void stft::reset()
+   {
+      _fill = size() - _hop;
+      std::fill(_in.begin(), _in.end(), 0.0f);
+      std::fill(_acc.begin(), _acc.end(), 0.0f);
+      std::fill(_ready.begin(), _ready.end(), 0.0f);
+   }
+
+   template <bool Synthesis, typename F>
+   inline void stft::frame(F&& f)
+   {
+      auto const n = size();
+      for (std::size_t i = 0; i != n; ++i)
+         _data[i] = _in[i] * _window[i];
+      _plan.rfft(_data.data());
+      f(_data.data());
+
+      if constexpr (Synthesis)
+      {
+         _plan.irfft(_data.data());
+         for (std::size_t i = 0; i != n; ++i)
+            _acc[i] += _data[i] * _window[i];
+
+         // The leading hop samples have all their overlaps: normalize them
+         // for output, and shift the accumulator by hop.
+         for (std::size_t j = 0; j != _hop; ++j)
+            _ready[j] = _acc[j] * _norm[j];
+         std::copy(_acc.begin() + _hop, _acc.end(), _acc.begin());
+         std::fill(_acc.end() - _hop, _acc.end(), 0.0f);
+      }
+
+      std::copy(_in.begin() + _hop, _in.end(), _in.begin());
+   }
+
+   template <bool Synthesis, typename F>
+   inline void stft::run(float const* in, float* out, std::size_t n, F&& f)
+   {
+      auto const size_ = size();
+      auto const start = size_ - _hop;
+      while (n)
+      {
+         // Up to the end of the frame
+         auto m = std::min(n, size_ - _fill);
+         std::copy(in, in + m, _in.begin() + _fill);
+
+         if constexpr (Synthesis)
+         {
+            // The sample that completes the frame outputs _ready[0] of
+            // that frame. Before it, the samples at frame positions start
+            // to size-2 output _ready[1] to _ready[hop-1] of the previous
+            // frame.
+            auto last = std::min(_fill + m, size_ - 1);
+            for (auto p = _fill; p < last; ++p)
+               *out++ = _ready[p - start + 1];
+         }
+
+         _fill += m;
+         in += m;
+         n -= m;
+
+         if (_fill == size_)
+         {
+            frame<Synthesis>(f);
+            _fill = start;
+            if constexpr (Synthesis)
+               *out++ = _ready[0];
+         }
+      }
+   }
+
+   template <typename F>
+   inline void stft::analyze(float const* in, std::size_t n, F&& f)
+   {
+      run<false>(in, nullptr, n, f);
+   }
+
+   template <typename F>
+   inline void stft::process(float const* in, float* out, std::size_t n, F&& f)
+   {
+      run<true>(in, out, n, f);
+   }
+}
+
+#endif
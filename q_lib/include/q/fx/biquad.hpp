@@ -10,13 +10,22 @@
 #include <q/support/base.hpp>
 #include <q/support/frequency.hpp>
 #include <q/support/literals.hpp>
+#include <q/detail/biquad_block.hpp>
 #include <cmath>
+#include <cstddef>
 
 namespace cycfi::q
 {
    ////////////////////////////////////////////////////////////////////////////
    // biquad class. Based on Audio-EQ Cookbook by Robert Bristow-Johnson.
    // https://www.w3.org/2011/audio/audio-eq-cookbook.html
+   //
+   // operator()(s) processes one sample, in direct form I. process(in,
+   // out, n) processes a block of n samples, with the same results up to
+   // rounding, and no more rounding error than operator(): four samples
+   // at a time with SSE2 (see detail::biquad_block_sse), and in
+   // transposed direct form II for the rest. Both keep the same state, so
+   // they can be mixed. in and out may be the same.
    ////////////////////////////////////////////////////////////////////////////
    struct biquad
    {
@@ -43,6 +52,19 @@ namespace cycfi::q
          return r;
       }
 
+      void process(float const* in, float* out, std::size_t n)
+      {
+         std::size_t i = 0;
+#if defined(__SSE2__)
+         i = detail::biquad_block_sse(
+            a0, a1, a2, a3, a4, x1, x2, y1, y2, in, out, n
+         );
+#endif
+         detail::biquad_block_tdf2(
+            a0, a1, a2, a3, a4, x1, x2, y1, y2, in + i, out + i, n - i
+         );
+      }
+
       void config(float a0_, float a1_, float a2_, float a3_, float a4_)
       {
          a0 = a0_;
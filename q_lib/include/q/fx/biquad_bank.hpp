@@ -0,0 +1,349 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_BIQUAD_BANK_HPP_OCTOBER_17_2026)
+#define CYCFI_Q_BIQUAD_BANK_HPP_OCTOBER_17_2026
+
+#include <q/fx/biquad.hpp>
+#include <q/support/multi_buffer.hpp>
+#include <array>
+#include <cstddef>
+
+#if defined(__SSE2__)
+# include <xmmintrin.h>
+#endif
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // biquad_bank: N biquads, one per channel, each with its own
+   // coefficients, processed together.
+   //
+   // The coefficients and the states are stored channel-interleaved
+   // (structure of arrays): one array per coefficient and per state
+   // variable, indexed by channel. With SSE2, four channels are processed
+   // at once, a SIMD lane per channel: blocks of 4 frames from 4 channels
+   // are loaded and transposed in registers, so that each vector holds one
+   // frame of the 4 channels, filtered with the recurrence of biquad (the
+   // direct form I of operator()), then transposed back and stored. Two
+   // such groups of 4 channels are interleaved, to overlap their
+   // recurrences. The remaining channels (N not a multiple of 4) are
+   // processed one at a time.
+   //
+   // config(ch, ...) sets the coefficients of channel ch, either directly
+   // or from any biquad (e.g. config(ch, peaking{ 3.0, 1_kHz, sps })).
+   // The channel's state is kept, as with biquad::config.
+   //
+   // process(in, out) filters the first N channels of in into the first N
+   // channels of out, for all the frames of in. in and out may share
+   // buffers.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   class biquad_bank
+   {
+   public:
+
+      static_assert(N >= 1, "biquad_bank needs at least one channel");
+
+      static constexpr std::size_t channels = N;
+
+                              biquad_bank();
+
+      void                    config(std::size_t ch, float b0, float b1, float b2, float a1, float a2);
+      void                    config(std::size_t ch, biquad const& f);
+
+      void                    process(
+                                 multi_buffer<float const> const& in
+                               , multi_buffer<float> const& out
+                              );
+
+      void                    reset();
+
+   private:
+
+      // Padded to whole groups of 4 channels, for aligned vector loads.
+      // The padding lanes are never processed.
+      static constexpr std::size_t size_ = (N + 3) / 4 * 4;
+      using lanes = std::array<float, size_>;
+
+      void                    process1(float const* in, float* out, std::size_t n, std::size_t ch);
+
+#if defined(__SSE2__)
+      void                    process4(
+                                 multi_buffer<float const> const& in
+                               , multi_buffer<float> const& out
+                               , std::size_t ch
+                              );
+      void                    process8(
+                                 multi_buffer<float const> const& in
+                               , multi_buffer<float> const& out
+                               , std::size_t ch
+                              );
+#endif
+
+      alignas(16) lanes       _b0, _b1, _b2, _a1, _a2;
+      alignas(16) lanes       _x1, _x2, _y1, _y2;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   inline biquad_bank<N>::biquad_bank()
+   {
+      // Pass-through until configured
+      _b0.fill(1.0f);
+      _b1.fill(0.0f);
+      _b2.fill(0.0f);
+      _a1.fill(0.0f);
+      _a2.fill(0.0f);
+      reset();
+   }
+
+   template <std::size_t N>
+   inline void biquad_bank<N>::config(
+      std::size_t ch, float b0, float b1, float b2, float a1, float a2)
+   {
+      _b0[ch] = b0;
+      _b1[ch] = b1;
+      _b2[ch] = b2;
+      _a1[ch] = a1;
+      _a2[ch] = a2;
+   }
+
+   template <std::size_t N>
+   inline void biquad_bank<N>::config(std::size_t ch, biquad const& f)
+   {
+      config(ch, f.a0, f.a1, f.a2, f.a3, f.a4);
+   }
+
+   template <std::size_t N>
+   inline void biquad_bank<N>::reset()
+   {
+      _x1.fill(0.0f);
+      _x2.fill(0.0f);
+      _y1.fill(0.0f);
+      _y2.fill(0.0f);
+   }
+
+   template <std::size_t N>
+   inline void biquad_bank<N>::process1(
+      float const* in, float* out, std::size_t n, std::size_t ch)
+   {
+      auto b0 = _b0[ch], b1 = _b1[ch], b2 = _b2[ch], a1 = _a1[ch], a2 = _a2[ch];
+      auto x1 = _x1[ch], x2 = _x2[ch], y1 = _y1[ch], y2 = _y2[ch];
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         auto x = in[i];
+         auto y = b0 * x + b1 * x1 + b2 * x2 - a2 * y2 - a1 * y1;
+         x2 = x1;
+         x1 = x;
+         y2 = y1;
+         y1 = y;
+         out[i] = y;
+      }
+      _x1[ch] = x1;
+      _x2[ch] = x2;
+      _y1[ch] = y1;
+      _y2[ch] = y2;
+   }
+
+#if defined(__SSE2__)
+   namespace detail
+   {
+      // The coefficients and the state of 4 channels, a lane per channel
+      struct biquad_lanes
+      {
+         biquad_lanes(
+            float const* b0_, float const* b1_, float const* b2_
+          , float const* a1_, float const* a2_
+          , float const* x1_, float const* x2_, float const* y1_, float const* y2_
+         )
+          : b0(_mm_load_ps(b0_)), b1(_mm_load_ps(b1_)), b2(_mm_load_ps(b2_))
+          , a1(_mm_load_ps(a1_)), a2(_mm_load_ps(a2_))
+          , x1(_mm_load_ps(x1_)), x2(_mm_load_ps(x2_))
+          , y1(_mm_load_ps(y1_)), y2(_mm_load_ps(y2_))
+         {}
+
+         void save(float* x1_, float* x2_, float* y1_, float* y2_) const
+         {
+            _mm_store_ps(x1_, x1);
+            _mm_store_ps(x2_, x2);
+            _mm_store_ps(y1_, y1);
+            _mm_store_ps(y2_, y2);
+         }
+
+         // One frame. The y1 term last: it is the only one that waits for
+         // the previous frame.
+         __m128 operator()(__m128 x)
+         {
+            auto ff = _mm_add_ps(
+               _mm_add_ps(_mm_mul_ps(b0, x), _mm_mul_ps(b1, x1))
+             , _mm_sub_ps(_mm_mul_ps(b2, x2), _mm_mul_ps(a2, y2))
+            );
+            auto y = _mm_sub_ps(ff, _mm_mul_ps(a1, y1));
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            return y;
+         }
+
+         __m128 b0, b1, b2, a1, a2;
+         __m128 x1, x2, y1, y2;
+      };
+
+      // 4 frames of 4 channels, transposed: f0..f3 hold frames i to i+3,
+      // a lane per channel
+      struct biquad_frames
+      {
+         void load(float const* const* src, std::size_t i)
+         {
+            f0 = _mm_loadu_ps(src[0] + i);
+            f1 = _mm_loadu_ps(src[1] + i);
+            f2 = _mm_loadu_ps(src[2] + i);
+            f3 = _mm_loadu_ps(src[3] + i);
+            _MM_TRANSPOSE4_PS(f0, f1, f2, f3);
+         }
+
+         void store(float* const* dst, std::size_t i)
+         {
+            _MM_TRANSPOSE4_PS(f0, f1, f2, f3);
+            _mm_storeu_ps(dst[0] + i, f0);
+            _mm_storeu_ps(dst[1] + i, f1);
+            _mm_storeu_ps(dst[2] + i, f2);
+            _mm_storeu_ps(dst[3] + i, f3);
+         }
+
+         __m128 f0, f1, f2, f3;
+      };
+
+      // One frame of 4 channels, for the frames that do not make a block
+      inline void biquad_lanes_frame(
+         biquad_lanes& f, float const* const* src, float* const* dst, std::size_t i)
+      {
+         alignas(16) float ys[4];
+         _mm_store_ps(ys, f(_mm_setr_ps(src[0][i], src[1][i], src[2][i], src[3][i])));
+         dst[0][i] = ys[0];
+         dst[1][i] = ys[1];
+         dst[2][i] = ys[2];
+         dst[3][i] = ys[3];
+      }
+   }
+
+   template <std::size_t N>
+   inline void biquad_bank<N>::process4(
+      multi_buffer<float const> const& in
+    , multi_buffer<float> const& out
+    , std::size_t ch
+   )
+   {
+      auto const n = in.frames.size();
+      float const* src[4] =
+         { in[ch].begin(), in[ch+1].begin(), in[ch+2].begin(), in[ch+3].begin() };
+      float* dst[4] =
+         { out[ch].begin(), out[ch+1].begin(), out[ch+2].begin(), out[ch+3].begin() };
+
+      detail::biquad_lanes f{
+         &_b0[ch], &_b1[ch], &_b2[ch], &_a1[ch], &_a2[ch]
+       , &_x1[ch], &_x2[ch], &_y1[ch], &_y2[ch]
+      };
+
+      std::size_t i = 0;
+      for (; i + 4 <= n; i += 4)
+      {
+         detail::biquad_frames r;
+         r.load(src, i);
+         r.f0 = f(r.f0);
+         r.f1 = f(r.f1);
+         r.f2 = f(r.f2);
+         r.f3 = f(r.f3);
+         r.store(dst, i);
+      }
+      for (; i != n; ++i)
+         detail::biquad_lanes_frame(f, src, dst, i);
+
+      f.save(&_x1[ch], &_x2[ch], &_y1[ch], &_y2[ch]);
+   }
+
+   template <std::size_t N>
+   inline void biquad_bank<N>::process8(
+      multi_buffer<float const> const& in
+    , multi_buffer<float> const& out
+    , std::size_t ch
+   )
+   {
+      // Two groups of 4 channels, interleaved frame by frame, to overlap
+      // their recurrences
+      auto const n = in.frames.size();
+      float const* src[8];
+      float* dst[8];
+      for (std::size_t k = 0; k != 8; ++k)
+      {
+         src[k] = in[ch + k].begin();
+         dst[k] = out[ch + k].begin();
+      }
+
+      auto c = ch + 4;
+      detail::biquad_lanes f{
+         &_b0[ch], &_b1[ch], &_b2[ch], &_a1[ch], &_a2[ch]
+       , &_x1[ch], &_x2[ch], &_y1[ch], &_y2[ch]
+      };
+      detail::biquad_lanes g{
+         &_b0[c], &_b1[c], &_b2[c], &_a1[c], &_a2[c]
+       , &_x1[c], &_x2[c], &_y1[c], &_y2[c]
+      };
+
+      std::size_t i = 0;
+      for (; i + 4 <= n; i += 4)
+      {
+         detail::biquad_frames r, s;
+         r.load(src, i);
+         s.load(src + 4, i);
+         r.f0 = f(r.f0);
+         s.f0 = g(s.f0);
+         r.f1 = f(r.f1);
+         s.f1 = g(s.f1);
+         r.f2 = f(r.f2);
+         s.f2 = g(s.f2);
+         r.f3 = f(r.f3);
+         s.f3 = g(s.f3);
+         r.store(dst, i);
+         s.store(dst + 4, i);
+      }
+      for (; i != n; ++i)
+      {
+         detail::biquad_lanes_frame(f, src, dst, i);
+         detail::biquad_lanes_frame(g, src + 4, dst + 4, i);
+      }
+
+      f.save(&_x1[ch], &_x2[ch], &_y1[ch], &_y2[ch]);
+      g.save(&_x1[c], &_x2[c], &_y1[c], &_y2[c]);
+   }
+#endif
+
+   template <std::size_t N>
+   inline void biquad_bank<N>::process(
+      multi_buffer<float const> const& in
+    , multi_buffer<float> const& out
+   )
+   {
+#if defined(__SSE2__)
+      constexpr std::size_t vector_end = N - N % 4;
+      std::size_t ch = 0;
+      for (; ch + 8 <= vector_end; ch += 8)
+         process8(in, out, ch);
+      if (ch != vector_end)
+         process4(in, out, ch);
+#else
+      constexpr std::size_t vector_end = 0;
+#endif
+      for (std::size_t ch = vector_end; ch != N; ++ch)
+         process1(in[ch].begin(), out[ch].begin(), in.frames.size(), ch);
+   }
+}
+
+#endif
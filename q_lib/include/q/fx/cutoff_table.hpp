@@ -0,0 +1,118 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_CUTOFF_TABLE_HPP_OCTOBER_17_2026)
+#define CYCFI_Q_CUTOFF_TABLE_HPP_OCTOBER_17_2026
+
+#include <q/support/base.hpp>
+#include <q/support/frequency.hpp>
+#include <q/support/pitch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // cutoff_table: the prewarped cutoff coefficient of the svf,
+   //
+   //    g = tan(pi * fc / sps)
+   //
+   // tabulated over log-frequency, for filters whose cutoff is modulated
+   // at audio rate. The table spans MIDI note 0 (8.18 Hz, see pitch) to
+   // max_ratio x sps (21.6 kHz at 48 kHz), with points_per_octave points
+   // per octave (48 by default, about 550 points), and is linearly
+   // interpolated. With the defaults, the relative error of g is below
+   // 1e-3 up to 0.4 x sps (fast_tan, used by svf::cutoff, is within
+   // 1.2e-3), and below 0.5% up to max_ratio x sps, where tan approaches
+   // its pole.
+   //
+   // The cutoff is given as a pitch (MIDI note number, fractional), which
+   // indexes the table directly, or as a frequency, converted with
+   // fast_log2. Cutoffs outside the table are clamped to its range.
+   //
+   // The table is computed once, at construction, and is immutable and
+   // reference counted: copies (e.g. one per voice) share it.
+   ////////////////////////////////////////////////////////////////////////////
+   class cutoff_table
+   {
+   public:
+
+      static constexpr float max_ratio = 0.45f;
+
+      explicit                cutoff_table(float sps, std::size_t points_per_octave = 48);
+
+      float                   operator()(pitch p) const;
+      float                   operator()(frequency f) const;
+      float                   operator()(float hz) const;
+
+      float                   sps() const          { return _sps; }
+
+   private:
+
+      float                   lookup(float x) const;
+
+      using table_ptr = std::shared_ptr<std::vector<float> const>;
+
+      table_ptr               _table;
+      float                   _sps;
+      float                   _points_per_note;    // table points per semitone
+      float                   _last;               // the index of max_ratio x sps
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   inline cutoff_table::cutoff_table(float sps, std::size_t points_per_octave)
+    : _sps(sps)
+    , _points_per_note(points_per_octave / 12.0f)
+   {
+      // The table is uniform in log-frequency, up to the first point at or
+      // above max_ratio x sps. Lookups are clamped to max_ratio x sps.
+      auto const base = as_double(pitch::base_frequency);
+      auto const top = std::log2(max_ratio * sps / base) * points_per_octave;
+      auto const size = std::size_t(std::ceil(top)) + 1;
+
+      std::vector<float> table(size);
+      for (std::size_t i = 0; i != size; ++i)
+      {
+         auto f = base * std::exp2(double(i) / points_per_octave);
+         table[i] = std::tan(pi * std::min(f / sps, 0.499));
+      }
+      _last = float(top);
+      _table = std::make_shared<std::vector<float> const>(std::move(table));
+   }
+
+   inline float cutoff_table::lookup(float x) const
+   {
+      x = std::clamp(x, 0.0f, _last);
+      auto i = std::min(std::size_t(x), _table->size() - 2);
+      auto frac = x - i;
+      auto const* t = _table->data() + i;
+      return t[0] + frac * (t[1] - t[0]);
+   }
+
+   inline float cutoff_table::operator()(pitch p) const
+   {
+      return lookup(as_float(p) * _points_per_note);
+   }
+
+   inline float cutoff_table::operator()(float hz) const
+   {
+      // pitch(f) = 12 * log2(f / base). Guard against log2 of 0 and below.
+      constexpr auto base = float(as_double(pitch::base_frequency));
+      auto note = 12.0f * fast_log2(std::max(hz, base) * (1.0f / base));
+      return lookup(note * _points_per_note);
+   }
+
+   inline float cutoff_table::operator()(frequency f) const
+   {
+      return (*this)(as_float(f));
+   }
+}
+
+#endif
@@ -151,6 +151,117 @@ namespace cycfi::q
    template <typename T>
    using fast_downsample_5 = basic_fast_downsample<5, T>;
 
+   ////////////////////////////////////////////////////////////////////////////
+   // basic_fast_downsample_cascade: a chain of basic_fast_downsample<N, T>
+   // stages, decimating by 2^stages, where the number of stages (up to
+   // MaxStages) is chosen at construction time. With zero stages, the
+   // input passes through unchanged.
+   //
+   // The function call operator takes one input sample at a time and
+   // returns true when an output sample is available (every
+   // factor() input samples), which out() then holds. Each stage keeps the
+   // first of a pair until the second arrives, so no buffering is needed
+   // beyond the stages' own state. The block form, given n samples at in,
+   // writes the outputs to out (which needs room for n samples: it doubles
+   // as the scratch buffer of the intermediate stages) and returns their
+   // number. It runs each stage over the whole block in turn, which is
+   // considerably faster than feeding the samples one at a time, with the
+   // same results.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N, typename T, std::size_t MaxStages = 4>
+   class basic_fast_downsample_cascade
+   {
+   public:
+
+      static constexpr std::size_t max_stages = MaxStages;
+
+      constexpr               basic_fast_downsample_cascade(std::size_t stages = 0)
+                               : _stages(stages < MaxStages? stages : MaxStages)
+                              {}
+
+      constexpr std::size_t   stages() const    { return _stages; }
+      constexpr std::size_t   factor() const    { return std::size_t(1) << _stages; }
+      constexpr T             out() const       { return _out; }
+
+      constexpr bool operator()(T s)
+      {
+         for (std::size_t k = 0; k != _stages; ++k)
+         {
+            if (!_odd[k])
+            {
+               _hold[k] = s;
+               _odd[k] = true;
+               return false;
+            }
+            _odd[k] = false;
+            s = _stage[k](_hold[k], s);
+         }
+         _out = s;
+         return true;
+      }
+
+      constexpr std::size_t operator()(T const* in, std::size_t n, T* out)
+      {
+         if (_stages == 0)
+         {
+            for (std::size_t i = 0; i != n; ++i)
+               out[i] = in[i];
+            if (n)
+               _out = in[n-1];
+            return n;
+         }
+
+         // One stage at a time over the whole block, in place from the
+         // second stage on (output j is written at or before input 2j).
+         for (std::size_t k = 0; k != _stages; ++k)
+         {
+            T const* src = (k == 0)? in : out;
+            std::size_t i = 0;
+            std::size_t j = 0;
+            if (_odd[k] && n != 0)
+            {
+               out[j++] = _stage[k](_hold[k], src[i++]);
+               _odd[k] = false;
+            }
+            auto stage = _stage[k];       // a local copy: out may alias it
+            for (; i + 2 <= n; i += 2)
+               out[j++] = stage(src[i], src[i+1]);
+            _stage[k] = stage;
+            if (i != n)
+            {
+               _hold[k] = src[i];
+               _odd[k] = true;
+            }
+            n = j;
+         }
+         if (n)
+            _out = out[n-1];
+         return n;
+      }
+
+      // The number of input samples taken toward the next output
+      constexpr std::size_t phase() const
+      {
+         std::size_t p = 0;
+         for (std::size_t k = 0; k != _stages; ++k)
+            p |= std::size_t(_odd[k]) << k;
+         return p;
+      }
+
+   private:
+
+      using stage_type = basic_fast_downsample<N, T>;
+
+      std::size_t                         _stages;
+      std::array<stage_type, MaxStages>   _stage = {};
+      std::array<T, MaxStages>            _hold = {};
+      std::array<bool, MaxStages>         _odd = {};
+      T                                   _out = {};
+   };
+
+   template <typename T>
+   using fast_downsample_cascade = basic_fast_downsample_cascade<5, T>;
+
    // fast_downsample was the three-tap class's original name, from before
    // there was more than one of them. Retained so existing code keeps
    // compiling.
@@ -0,0 +1,423 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_FIR_HPP_OCTOBER_17_2026)
+#define CYCFI_Q_FIR_HPP_OCTOBER_17_2026
+
+#include <q/support/base.hpp>
+#include <q/support/frequency.hpp>
+#include <q/detail/dot_product.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace cycfi::q
+{
+   namespace detail
+   {
+      template <typename T>
+      class fir_history;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // fir: a finite impulse response filter,
+   //
+   //    y[n] = h[0] x[n] + h[1] x[n-1] + ... + h[N-1] x[n-N+1]
+   //
+   // for any number of taps, N. The coefficients h are stored reversed,
+   // aligned, and padded with leading zeros to a multiple of 8, so that
+   // each output is a dot product of the coefficients with the last inputs,
+   // vectorized across the taps (see detail/dot_product.hpp).
+   //
+   // The inputs are kept in a linear history buffer, several times the
+   // length of the filter, and the last inputs are always contiguous, so
+   // the reads never wrap. When the buffer is full, its last N-1 inputs
+   // are moved to the front, once every few N samples. process(in, out, n)
+   // appends runs of inputs to the history, then computes their outputs in
+   // a tight loop. out may be in.
+   //
+   // T is float (vectorized with AVX or SSE2) or double.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T = float>
+   class fir
+   {
+   public:
+
+      explicit                fir(std::vector<T> const& coefs);
+                              fir(T const* coefs, std::size_t n);
+
+      T                       operator()(T s);
+      void                    process(T const* in, T* out, std::size_t n);
+      void                    reset();
+
+      std::size_t             size() const         { return _size; }
+
+   private:
+
+      std::size_t             _size;
+      detail::aligned_vector<T> _coefs;
+      detail::fir_history<T>  _history;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // fir_decimator: a FIR lowpass followed by decimation by factor: only
+   // every factor-th output is computed. process(in, out, n) writes n
+   // outputs from the n x factor samples of in. out may be in.
+   //
+   // The coefficients are typically a lowpass with a cutoff below
+   // sps / (2 x factor) (see kaiser_lowpass below).
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T = float>
+   class fir_decimator
+   {
+   public:
+
+                              fir_decimator(std::vector<T> const& coefs, std::size_t factor);
+
+      void                    process(T const* in, T* out, std::size_t n);
+      void                    reset();
+
+      std::size_t             factor() const       { return _factor; }
+
+   private:
+
+      std::size_t             _factor;
+      detail::aligned_vector<T> _coefs;
+      detail::fir_history<T>  _history;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // fir_interpolator: interpolation by factor: zero-stuffing followed by a
+   // FIR lowpass, in polyphase form. The filter is split into factor
+   // subfilters (phases), h[p], h[p + factor], h[p + 2 factor]..., for p
+   // from 0 to factor-1, each producing one of the factor outputs per input
+   // from the inputs alone, so the products with the stuffed zeros are
+   // never computed. process(in, out, n) writes the n x factor samples of
+   // out from the n samples of in.
+   //
+   // The coefficients are a lowpass with unity gain at DC, typically with a
+   // cutoff below sps / 2 (of the input rate). They are scaled by factor,
+   // the gain lost to the zero-stuffing.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T = float>
+   class fir_interpolator
+   {
+   public:
+
+                              fir_interpolator(std::vector<T> const& coefs, std::size_t factor);
+
+      void                    process(T const* in, T* out, std::size_t n);
+      void                    reset();
+
+      std::size_t             factor() const       { return _factor; }
+
+   private:
+
+      std::size_t             _factor;
+      std::size_t             _span;      // the padded length of a phase
+      detail::aligned_vector<T> _phases;  // the phases, one after the other
+      detail::fir_history<T>  _history;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // FIR design: windowed-sinc lowpass filters, with a Kaiser window.
+   //
+   // windowed_sinc(taps, cutoff, beta) returns the taps coefficients of a
+   // lowpass with the cutoff (relative to the sample rate, 0 to 0.5) at
+   // the middle of the transition band, where the gain is -6 dB. The
+   // coefficients are symmetric (linear phase), with a delay of (taps-1)/2
+   // samples, and are normalized for unity gain at DC.
+   //
+   // The Kaiser window trades the width of the transition band for the
+   // stopband attenuation, A (in dB), through beta. kaiser_beta(A) and
+   // kaiser_taps(A, transition) give the beta and the (odd) number of taps
+   // that reach A with a transition band of the given width (relative to
+   // the sample rate), from Kaiser's formulas.
+   //
+   // kaiser_lowpass(cutoff, transition, sps, A) puts it together: a lowpass
+   // with cutoff and transition in Hz, and A dB of stopband attenuation
+   // (80 by default). The passband ends at cutoff - transition / 2, and the
+   // stopband starts at cutoff + transition / 2.
+   ////////////////////////////////////////////////////////////////////////////
+   double                     kaiser_beta(double attenuation);
+   std::size_t                kaiser_taps(double attenuation, double transition);
+
+   template <typename T = float>
+   std::vector<T>             windowed_sinc(std::size_t taps, double cutoff, double beta);
+
+   template <typename T = float>
+   std::vector<T>             kaiser_lowpass(
+                                 frequency cutoff, frequency transition
+                               , float sps, double attenuation = 80
+                              );
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   namespace detail
+   {
+      // The linear history buffer of the FIR filters. push(s) appends s and
+      // returns the last span inputs, oldest first, contiguous.
+      //
+      // push(in, n) appends a run of inputs: as many of the n inputs of in
+      // as fit before the buffer is full (n is updated), and returns the
+      // window of the first: the window of the i-th is at i past it.
+      template <typename T>
+      class fir_history
+      {
+      public:
+
+         explicit fir_history(std::size_t span)
+          : _span(span)
+          , _buffer(span - 1 + std::max<std::size_t>(4 * span, 256), T(0))
+          , _pos(span - 1)
+         {}
+
+         T const* push(T s)
+         {
+            if (_pos == _buffer.size())
+            {
+               std::copy(_buffer.end() - (_span - 1), _buffer.end(), _buffer.begin());
+               _pos = _span - 1;
+            }
+            _buffer[_pos++] = s;
+            return _buffer.data() + _pos - _span;
+         }
+
+         T const* push(T const* in, std::size_t& n)
+         {
+            if (_pos == _buffer.size())
+            {
+               std::copy(_buffer.end() - (_span - 1), _buffer.end(), _buffer.begin());
+               _pos = _span - 1;
+            }
+            n = std::min(n, _buffer.size() - _pos);
+            std::copy(in, in + n, _buffer.begin() + _pos);
+            auto const* window = _buffer.data() + _pos + 1 - _span;
+            _pos += n;
+            return window;
+         }
+
+         void reset()
+         {
+            std::fill(_buffer.begin(), _buffer.end(), T(0));
+            _pos = _span - 1;
+         }
+
+      private:
+
+         std::size_t       _span;
+         std::vector<T>    _buffer;
+         std::size_t       _pos;
+      };
+
+      // The coefficients, reversed, with leading zeros up to span
+      template <typename T>
+      inline void fir_reversed(T const* coefs, std::size_t n, T scale, T* dst, std::size_t span)
+      {
+         std::fill(dst, dst + span - n, T(0));
+         for (std::size_t i = 0; i != n; ++i)
+            dst[span - 1 - i] = coefs[i] * scale;
+      }
+
+      // Checked before anything is allocated. Returns taps.
+      inline std::size_t fir_check(std::size_t taps, std::size_t factor)
+      {
+#if __cpp_exceptions == 199711
+         if (taps == 0)
+            throw std::runtime_error("Error: FIR filter needs at least one coefficient.");
+         if (factor == 0)
+            throw std::runtime_error("Error: FIR resampling factor must be at least 1.");
+#endif
+         return taps;
+      }
+
+      // The modified Bessel function of the first kind, order 0
+      inline double bessel_i0(double x)
+      {
+         double sum = 1.0, term = 1.0;
+         auto const x2 = x * x / 4;
+         for (int k = 1; term > 1e-12 * sum; ++k)
+         {
+            term *= x2 / (double(k) * k);
+            sum += term;
+         }
+         return sum;
+      }
+   }
+
+   template <typename T>
+   inline fir<T>::fir(T const* coefs, std::size_t n)
+    : _size(detail::fir_check(n, 1))
+    , _coefs(detail::simd_padded(n))
+    , _history(detail::simd_padded(n))
+   {
+      detail::fir_reversed(coefs, n, T(1), _coefs.data(), _coefs.size());
+   }
+
+   template <typename T>
+   inline fir<T>::fir(std::vector<T> const& coefs)
+    : fir(coefs.data(), coefs.size())
+   {}
+
+   template <typename T>
+   inline T fir<T>::operator()(T s)
+   {
+      return detail::dot_product(_coefs.data(), _history.push(s), _coefs.size());
+   }
+
+   template <typename T>
+   inline void fir<T>::process(T const* in, T* out, std::size_t n)
+   {
+      auto const* h = _coefs.data();
+      auto const span = _coefs.size();
+      for (std::size_t i = 0; i != n;)
+      {
+         // The inputs are copied to the history before the outputs are
+         // written: in may be out.
+         auto m = n - i;
+         auto const* x = _history.push(in + i, m);
+         for (std::size_t j = 0; j != m; ++j)
+            out[i + j] = detail::dot_product(h, x + j, span);
+         i += m;
+      }
+   }
+
+   template <typename T>
+   inline void fir<T>::reset()
+   {
+      _history.reset();
+   }
+
+   template <typename T>
+   inline fir_decimator<T>::fir_decimator(std::vector<T> const& coefs, std::size_t factor)
+    : _factor(factor)
+    , _coefs(detail::simd_padded(detail::fir_check(coefs.size(), factor)))
+    , _history(_coefs.size())
+   {
+      detail::fir_reversed(coefs.data(), coefs.size(), T(1), _coefs.data(), _coefs.size());
+   }
+
+   template <typename T>
+   inline void fir_decimator<T>::process(T const* in, T* out, std::size_t n)
+   {
+      auto const* h = _coefs.data();
+      auto const span = _coefs.size();
+      auto const total = n * _factor;
+      for (std::size_t i = 0; i != total;)
+      {
+         // Only the last of every factor inputs, k, has its output computed
+         auto m = total - i;
+         auto const* x = _history.push(in + i, m);
+         auto k = i + (_factor - 1 - i % _factor);
+         for (; k < i + m; k += _factor)
+            out[k / _factor] = detail::dot_product(h, x + (k - i), span);
+         i += m;
+      }
+   }
+
+   template <typename T>
+   inline void fir_decimator<T>::reset()
+   {
+      _history.reset();
+   }
+
+   template <typename T>
+   inline fir_interpolator<T>::fir_interpolator(std::vector<T> const& coefs, std::size_t factor)
+    : _factor(factor)
+    , _span(detail::simd_padded(
+         (detail::fir_check(coefs.size(), factor) + factor - 1) / factor))
+    , _phases(_span * factor)
+    , _history(_span)
+   {
+      // Phase p: h[p], h[p + factor], h[p + 2 factor]...
+      std::vector<T> phase;
+      for (std::size_t p = 0; p != factor; ++p)
+      {
+         phase.clear();
+         for (std::size_t i = p; i < coefs.size(); i += factor)
+            phase.push_back(coefs[i]);
+         detail::fir_reversed(
+            phase.data(), phase.size(), T(factor), _phases.data() + p * _span, _span);
+      }
+   }
+
+   template <typename T>
+   inline void fir_interpolator<T>::process(T const* in, T* out, std::size_t n)
+   {
+      auto const* h = _phases.data();
+      for (std::size_t i = 0; i != n;)
+      {
+         auto m = n - i;
+         auto const* x = _history.push(in + i, m);
+         for (std::size_t j = 0; j != m; ++j)
+         {
+            for (std::size_t p = 0; p != _factor; ++p)
+               *out++ = detail::dot_product(h + p * _span, x + j, _span);
+         }
+         i += m;
+      }
+   }
+
+   template <typename T>
+   inline void fir_interpolator<T>::reset()
+   {
+      _history.reset();
+   }
+
+   inline double kaiser_beta(double attenuation)
+   {
+      auto const a = attenuation;
+      if (a > 50)
+         return 0.1102 * (a - 8.7);
+      if (a >= 21)
+         return 0.5842 * std::pow(a - 21, 0.4) + 0.07886 * (a - 21);
+      return 0.0;
+   }
+
+   inline std::size_t kaiser_taps(double attenuation, double transition)
+   {
+      // Kaiser's estimate of the order, rounded up to even: an odd number
+      // of taps, for a delay of a whole number of samples.
+      auto order = std::ceil((attenuation - 7.95) / (2.285 * 2 * pi * transition));
+      auto n = std::size_t(std::max(order, 2.0));
+      return (n + 1) / 2 * 2 + 1;
+   }
+
+   template <typename T>
+   inline std::vector<T> windowed_sinc(std::size_t taps, double cutoff, double beta)
+   {
+      std::vector<T> h(taps);
+      auto const mid = (taps - 1) / 2.0;
+      auto const i0_beta = detail::bessel_i0(beta);
+      double sum = 0;
+      std::vector<double> hd(taps);
+      for (std::size_t i = 0; i != taps; ++i)
+      {
+         auto t = i - mid;
+         auto sinc = (t == 0)? 2 * cutoff : std::sin(2 * pi * cutoff * t) / (pi * t);
+         auto r = (mid == 0)? 0.0 : t / mid;
+         auto w = detail::bessel_i0(beta * std::sqrt(std::max(0.0, 1 - r * r))) / i0_beta;
+         hd[i] = sinc * w;
+         sum += hd[i];
+      }
+      for (std::size_t i = 0; i != taps; ++i)
+         h[i] = T(hd[i] / sum);
+      return h;
+   }
+
+   template <typename T>
+   inline std::vector<T> kaiser_lowpass(
+      frequency cutoff, frequency transition, float sps, double attenuation)
+   {
+      auto const taps = kaiser_taps(attenuation, as_double(transition) / sps);
+      return windowed_sinc<T>(taps, as_double(cutoff) / sps, kaiser_beta(attenuation));
+   }
+}
+
+#endif
@@ -0,0 +1,287 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_LOOKAHEAD_LIMITER_HPP_OCTOBER_17_2026)
+#define CYCFI_Q_LOOKAHEAD_LIMITER_HPP_OCTOBER_17_2026
+
+#include <q/support/base.hpp>
+#include <q/support/decibel.hpp>
+#include <q/fx/moving_maximum.hpp>
+#include <q/fx/moving_sum.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#if defined(__AVX__) || defined(__SSE2__)
+# include <immintrin.h>
+#endif
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // lookahead_limiter: a brickwall limiter: the output never exceeds the
+   // threshold. The audio is delayed by the lookahead, L samples, so that
+   // the gain is already down when a peak comes out.
+   //
+   // The gain is computed in the linear domain, with no dB conversions:
+   //
+   //    1. The peak of the last L+1 input samples, the delayed sample and
+   //       the L samples ahead of it, is tracked with fast_moving_maximum,
+   //       a block at a time.
+   //
+   //    2. The gain that brings that peak to the threshold, threshold /
+   //       peak (1 below the threshold), is followed at once when it falls,
+   //       and with the release when it rises (a one-pole smoother, see
+   //       ar_envelope_follower for the duration convention).
+   //
+   //    3. The result is averaged over L+1 samples, for an attack that
+   //       ramps the gain down over the lookahead instead of stepping it.
+   //
+   // Steps 2 and 3 work on the gain reduction, 1 - gain, not the gain.
+   // The release decays it towards 0, where a float has all the
+   // precision it needs (released towards 1, the gain would stall about
+   // 4e-5 short of it). Below min_reduction, it snaps to 0, and once the
+   // moving sum holds only zeros, it is cleared, so that whatever the
+   // running time, with no reduction, the gain is exactly 1.
+   //
+   // Each of the averaged gains is at or below the gain needed by the
+   // delayed sample, so their average is too: the limiting is brickwall.
+   // The final multiply also clamps to the threshold, which catches the
+   // rounding of the average.
+   //
+   // process(in, out, n) limits a block of n samples. The stereo overload
+   // links the channels: the gain follows the larger of the two and
+   // applies to both. in and out may be the same. The gain is applied
+   // with SIMD (AVX or SSE2), in blocks of block_size samples, over a ring
+   // buffer delay.
+   //
+   // The latency is L = lookahead x sps samples. Typical lookaheads are
+   // 1 to 5 ms.
+   ////////////////////////////////////////////////////////////////////////////
+   class lookahead_limiter
+   {
+   public:
+
+      static constexpr std::size_t block_size = 64;
+      static constexpr float min_reduction = 1e-9f;
+
+                              lookahead_limiter(
+                                 duration lookahead
+                               , duration release
+                               , decibel threshold
+                               , float sps
+                              );
+
+      float                   operator()(float s);
+      void                    process(float const* in, float* out, std::size_t n);
+      void                    process(
+                                 float const* in_left, float const* in_right
+                               , float* out_left, float* out_right
+                               , std::size_t n
+                              );
+
+      void                    threshold(decibel val);
+      decibel                 threshold() const    { return _threshold_db; }
+      void                    release(duration val, float sps);
+
+      float                   gain() const         { return _gain; }
+      std::size_t             latency() const      { return _lookahead; }
+      void                    reset();
+
+   private:
+
+      template <std::size_t C>
+      void                    process_block(
+                                 std::array<float const*, C> in
+                               , std::array<float*, C> out
+                               , std::size_t n
+                              );
+
+      std::size_t             _lookahead;
+      decibel                 _threshold_db;
+      float                   _threshold;
+      float                   _release;
+      fast_moving_maximum<float> _peak;
+      basic_moving_sum<float> _average;
+      float                   _reduction; // the released gain reduction
+      std::size_t             _zeros;     // the run of zero reductions
+      float                   _gain;      // the last gain applied
+      std::array<std::vector<float>, 2> _delay;
+      std::size_t             _mask;
+      std::size_t             _pos;
+      std::array<float, block_size> _gains;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   namespace detail
+   {
+      // out[i] = x[i] * g[i], clamped to [-limit, limit]
+      inline void apply_gain(
+         float const* x, float const* g, float* out, std::size_t n, float limit)
+      {
+         std::size_t i = 0;
+#if defined(__AVX__)
+         auto const hi8 = _mm256_set1_ps(limit);
+         auto const lo8 = _mm256_set1_ps(-limit);
+         for (; i + 8 <= n; i += 8)
+         {
+            auto y = _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(g + i));
+            _mm256_storeu_ps(out + i, _mm256_max_ps(_mm256_min_ps(y, hi8), lo8));
+         }
+#endif
+#if defined(__AVX__) || defined(__SSE2__)
+         auto const hi4 = _mm_set1_ps(limit);
+         auto const lo4 = _mm_set1_ps(-limit);
+         for (; i + 4 <= n; i += 4)
+         {
+            auto y = _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(g + i));
+            _mm_storeu_ps(out + i, _mm_max_ps(_mm_min_ps(y, hi4), lo4));
+         }
+#endif
+         for (; i != n; ++i)
+            out[i] = std::clamp(x[i] * g[i], -limit, limit);
+      }
+   }
+
+   inline lookahead_limiter::lookahead_limiter(
+      duration lookahead
+    , duration release
+    , decibel threshold
+    , float sps
+   )
+    : _lookahead(std::size_t(as_float(lookahead) * sps))
+    , _threshold_db(threshold)
+    , _threshold(lin_float(threshold))
+    , _peak(_lookahead + 1)
+    , _average(_lookahead + 1)
+    , _mask(smallest_pow2(_lookahead + block_size) - 1)
+   {
+      this->release(release, sps);
+      for (auto& d : _delay)
+         d.resize(_mask + 1);
+      reset();
+   }
+
+   inline void lookahead_limiter::threshold(decibel val)
+   {
+      _threshold_db = val;
+      _threshold = lin_float(val);
+   }
+
+   inline void lookahead_limiter::release(duration val, float sps)
+   {
+      _release = fast_exp3(-2.0f / (sps * as_float(val)));
+   }
+
+   inline void lookahead_limiter::reset()
+   {
+      _peak.reset();
+      _average.clear();
+      _reduction = 0.0f;
+      _zeros = 0;
+      _gain = 1.0f;
+      for (auto& d : _delay)
+         std::fill(d.begin(), d.end(), 0.0f);
+      _pos = 0;
+   }
+
+   template <std::size_t C>
+   inline void lookahead_limiter::process_block(
+      std::array<float const*, C> in
+    , std::array<float*, C> out
+    , std::size_t n
+   )
+   {
+      // The peaks, then the gains, one per sample
+      auto* gains = _gains.data();
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         auto s = std::abs(in[0][i]);
+         if constexpr (C == 2)
+            s = std::max(s, std::abs(in[1][i]));
+         gains[i] = s;
+      }
+      _peak.process(gains, gains, n);
+
+      auto const threshold = _threshold;
+      auto const release = _release;
+      auto const scale = 1.0f / (_lookahead + 1);
+      auto const window = _lookahead + 1;
+      auto reduction = _reduction;
+      auto zeros = _zeros;
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         auto peak = gains[i];
+         auto r = (peak > threshold)? 1.0f - threshold / peak : 0.0f;
+         reduction = (r > reduction)? r : r + release * (reduction - r);
+         if (reduction < min_reduction)
+            reduction = 0.0f;
+
+         // Only zeros in the window: the sum is exactly 0
+         zeros = (reduction == 0.0f)? zeros + 1 : 0;
+         if (zeros == window)
+            _average.clear();
+
+         gains[i] = 1.0f - _average(reduction) * scale;
+      }
+      _reduction = reduction;
+      _zeros = zeros;
+      _gain = _gains[n - 1];
+
+      // The delay: write the block, then read the block L samples behind
+      // it, in at most two contiguous pieces each. The ring holds at least
+      // L + block_size samples, so the two do not overlap, and in may be
+      // out.
+      auto const size = _mask + 1;
+      auto const read = (_pos + size - _lookahead) & _mask;
+      for (std::size_t c = 0; c != C; ++c)
+      {
+         auto* ring = _delay[c].data();
+         auto m = std::min(n, size - _pos);
+         std::copy(in[c], in[c] + m, ring + _pos);
+         std::copy(in[c] + m, in[c] + n, ring);
+
+         m = std::min(n, size - read);
+         detail::apply_gain(ring + read, _gains.data(), out[c], m, threshold);
+         detail::apply_gain(ring, _gains.data() + m, out[c] + m, n - m, threshold);
+      }
+      _pos = (_pos + n) & _mask;
+   }
+
+   inline void lookahead_limiter::process(float const* in, float* out, std::size_t n)
+   {
+      for (std::size_t i = 0; i < n; i += block_size)
+      {
+         auto m = std::min(block_size, n - i);
+         process_block<1>({ in + i }, { out + i }, m);
+      }
+   }
+
+   inline void lookahead_limiter::process(
+      float const* in_left, float const* in_right
+    , float* out_left, float* out_right
+    , std::size_t n
+   )
+   {
+      for (std::size_t i = 0; i < n; i += block_size)
+      {
+         auto m = std::min(block_size, n - i);
+         process_block<2>({ in_left + i, in_right + i }, { out_left + i, out_right + i }, m);
+      }
+   }
+
+   inline float lookahead_limiter::operator()(float s)
+   {
+      float out;
+      process_block<1>({ &s }, { &out }, 1);
+      return out;
+   }
+}
+
+#endif
@@ -0,0 +1,176 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_MODULATED_SVF_HPP_OCTOBER_17_2026)
+#define CYCFI_Q_MODULATED_SVF_HPP_OCTOBER_17_2026
+
+#include <q/fx/svf.hpp>
+#include <q/fx/cutoff_table.hpp>
+#include <algorithm>
+#include <cstddef>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // modulated_svf: the TPT svf (svf.hpp), for a cutoff modulated at audio
+   // rate, in blocks.
+   //
+   // process(in, out, cutoff, n) filters n samples of in, with the cutoff
+   // (in Hz) given per sample in the cutoff array, and writes the lowpass
+   // output to out. Instead of recomputing the coefficients every sample
+   // (a tan and a divide, as svf::cutoff does), the cutoff is sampled at
+   // control points, every ramp_size samples: the cutoff coefficient g is
+   // read from a cutoff_table, the svf coefficients computed from it, and
+   // the coefficients are ramped linearly from the previous control point
+   // to this one. Per sample, the cost is the svf tick plus three adds.
+   // The modulation is thus followed at sps / ramp_size (3 kHz at 48 kHz),
+   // which is well above the rate of envelopes and LFOs, with no steps.
+   //
+   // process(in, out, f, n) glides the cutoff to the frequency f over the
+   // block, for a cutoff updated once per block.
+   //
+   // The resonance is set as for svf, and ramps in at the next control
+   // point. in and out may be the same.
+   ////////////////////////////////////////////////////////////////////////////
+   class modulated_svf
+   {
+   public:
+
+      static constexpr std::size_t ramp_size = 16;
+
+                              modulated_svf(
+                                 cutoff_table const& table
+                               , frequency f
+                               , double q = svf::default_q
+                              );
+
+      void                    process(
+                                 float const* in, float* out
+                               , float const* cutoff, std::size_t n
+                              );
+
+      void                    process(
+                                 float const* in, float* out
+                               , frequency f, std::size_t n
+                              );
+
+      void                    resonance(double q);
+      void                    normalized_resonance(float r);
+      void                    reset();
+
+   private:
+
+      struct coefficients
+      {
+         float a1, a2, a3;
+      };
+
+      coefficients            coefficients_of(float g) const;
+
+      template <typename G>
+      void                    run(float const* in, float* out, std::size_t n, G&& g_at);
+
+      cutoff_table            _table;
+      float                   _k;
+      coefficients            _c;
+      float                   _g;
+      float                   _ic1eq = 0.0f;
+      float                   _ic2eq = 0.0f;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   inline modulated_svf::modulated_svf(
+      cutoff_table const& table, frequency f, double q)
+    : _table(table)
+    , _k(1.0 / q)
+    , _g(table(f))
+   {
+      _c = coefficients_of(_g);
+   }
+
+   inline modulated_svf::coefficients modulated_svf::coefficients_of(float g) const
+   {
+      // As svf::update
+      auto a1 = 1.0f / (1.0f + g * (g + _k));
+      auto a2 = g * a1;
+      return { a1, a2, g * a2 };
+   }
+
+   inline void modulated_svf::resonance(double q)
+   {
+      _k = 1.0 / q;
+   }
+
+   inline void modulated_svf::normalized_resonance(float r)
+   {
+      _k = 2.0f * (1.0f - r);
+   }
+
+   inline void modulated_svf::reset()
+   {
+      _ic1eq = _ic2eq = 0.0f;
+   }
+
+   template <typename G>
+   inline void modulated_svf::run(float const* in, float* out, std::size_t n, G&& g_at)
+   {
+      auto ic1eq = _ic1eq, ic2eq = _ic2eq;
+      auto c = _c;
+      for (std::size_t i = 0; i < n; i += ramp_size)
+      {
+         // The control point at the end of this segment
+         auto m = std::min(ramp_size, n - i);
+         _g = g_at(i + m - 1);
+         auto target = coefficients_of(_g);
+
+         auto const r = 1.0f / m;
+         coefficients const d = {
+            (target.a1 - c.a1) * r, (target.a2 - c.a2) * r, (target.a3 - c.a3) * r
+         };
+
+         for (std::size_t j = i; j != i + m; ++j)
+         {
+            c.a1 += d.a1;
+            c.a2 += d.a2;
+            c.a3 += d.a3;
+
+            // The svf tick (svf::operator())
+            auto v3 = in[j] - ic2eq;
+            auto v1 = c.a1 * ic1eq + c.a2 * v3;
+            auto v2 = ic2eq + c.a2 * ic1eq + c.a3 * v3;
+            ic1eq = 2.0f * v1 - ic1eq;
+            ic2eq = 2.0f * v2 - ic2eq;
+            out[j] = v2;
+         }
+
+         // Land exactly on the control point
+         c = target;
+      }
+      _c = c;
+      _ic1eq = ic1eq;
+      _ic2eq = ic2eq;
+   }
+
+   inline void modulated_svf::process(
+      float const* in, float* out, float const* cutoff, std::size_t n)
+   {
+      run(in, out, n, [&](std::size_t i) { return _table(cutoff[i]); });
+   }
+
+   inline void modulated_svf::process(
+      float const* in, float* out, frequency f, std::size_t n)
+   {
+      // A linear glide of g, from the current cutoff to f
+      auto const g0 = _g;
+      auto const g1 = _table(f);
+      auto const dg = (g1 - g0) / std::max<std::size_t>(n, 1);
+      run(in, out, n, [&](std::size_t i) { return g0 + dg * (i + 1); });
+   }
+}
+
+#endif
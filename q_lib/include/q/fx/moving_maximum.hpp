@@ -8,10 +8,24 @@
 #define CYCFI_Q_EXP_MOVING_MAXIMUM_NOVEMBER_6_2019
 
 #include <q/support/base.hpp>
+#include <q/support/duration.hpp>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
 namespace cycfi::q
 {
+   namespace detail
+   {
+      template <typename T, typename Compare>
+      struct moving_extremum;
+
+      template <typename T, typename Compare>
+      class fast_moving_extremum;
+   }
+
    ////////////////////////////////////////////////////////////////////////////
    // moving_maximum: an efficient sliding maximum algorithm that has cost
    // that is O(log2(L)).
@@ -21,59 +35,215 @@ namespace cycfi::q
    // DIGITAL SIGNAL PROCESSING, VOL. 47, NO. 9, SEPTEMBER 2000
    //
    // Many thanks to Robert Bristow-Johnson.
+   //
+   // moving_minimum is the same, for the sliding minimum.
    ////////////////////////////////////////////////////////////////////////////
    template <typename T>
-   struct moving_maximum
+   struct moving_maximum : detail::moving_extremum<T, std::greater<T>>
    {
-      moving_maximum(duration d, float sps)
-       : moving_maximum(std::size_t(as_float(d) * sps))
-      {}
+      using detail::moving_extremum<T, std::greater<T>>::moving_extremum;
+   };
 
-      moving_maximum(std::size_t size)
-       : _size(size)
-       , _input_index(0)
+   template <typename T>
+   struct moving_minimum : detail::moving_extremum<T, std::less<T>>
+   {
+      using detail::moving_extremum<T, std::less<T>>::moving_extremum;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // fast_moving_maximum: the sliding maximum in O(1), with at most three
+   // comparisons per sample, independent of the window size, L.
+   //
+   // van Herk, "A fast algorithm for local minimum and maximum filters on
+   // rectangular and octagonal kernels", Pattern Recognition Letters 13,
+   // 1992, and Gil and Werman, "Computing 2-D Min, Median, and Max
+   // Filters", IEEE Transactions on PAMI 15, 1993.
+   //
+   // The input is split into blocks of L samples. The window ending at the
+   // latest sample spans the tail of the previous block and the head of
+   // the current one. The maximum of the head is kept as a running
+   // maximum (one comparison per sample), and the maxima of all the tails
+   // of the previous block are computed once, when it completes (one
+   // comparison per sample, amortized). The result is the larger of the
+   // two (one more comparison).
+   //
+   // The cost is amortized: every L samples, one sample does the L-1
+   // comparisons of a block. process(in, out, n) computes the sliding
+   // maximum of a block of n samples. in may be out.
+   //
+   // fast_moving_minimum is the same, for the sliding minimum.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T>
+   struct fast_moving_maximum : detail::fast_moving_extremum<T, std::greater<T>>
+   {
+      using detail::fast_moving_extremum<T, std::greater<T>>::fast_moving_extremum;
+   };
+
+   template <typename T>
+   struct fast_moving_minimum : detail::fast_moving_extremum<T, std::less<T>>
+   {
+      using detail::fast_moving_extremum<T, std::less<T>>::fast_moving_extremum;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   namespace detail
+   {
+      // The value that never wins: the lowest for the maximum, the highest
+      // for the minimum.
+      template <typename T, typename Compare>
+      constexpr T extremum_identity()
       {
-         constexpr T very_large_number = 3.40e38;
-         std::size_t capacity = smallest_pow2(size);
-         _data.resize(capacity * 2, T{});
-         std::fill(_data.begin(), _data.end(), -very_large_number);
+         if constexpr (std::is_base_of_v<std::greater<T>, Compare>)
+            return std::numeric_limits<T>::lowest();
+         else
+            return std::numeric_limits<T>::max();
       }
 
-      T operator()(T value)
+      template <typename T, typename Compare>
+      struct moving_extremum
       {
-         T* array = &_data[0];
+         moving_extremum(duration d, float sps)
+          : moving_extremum(std::size_t(as_float(d) * sps))
+         {}
 
-         // our main buffer is in the latter half of the array.
-         std::size_t index = (_data.size()/2) + _input_index;
+         moving_extremum(std::size_t size)
+          : _size(size)
+          , _input_index(0)
+         {
+            std::size_t capacity = smallest_pow2(size);
+            _data.resize(capacity * 2, extremum_identity<T, Compare>());
+         }
 
-         while (index > 1)
+         T operator()(T value)
          {
-            array[index] = value;
+            Compare better;
+            T* array = &_data[0];
 
-            // toggle LSB, the upper bits of the sibling address are the same.
-            T sibling_value = array[index ^ 1];
+            // our main buffer is in the latter half of the array.
+            std::size_t index = (_data.size()/2) + _input_index;
 
-            if (value < sibling_value)
+            while (index > 1)
             {
-               // use maximum of the two values
-               value = sibling_value;
+               array[index] = value;
+
+               // toggle LSB, the upper bits of the sibling address are the same.
+               T sibling_value = array[index ^ 1];
+
+               if (better(sibling_value, value))
+               {
+                  // use the extremum of the two values
+                  value = sibling_value;
+               }
+               // parent address is index/2 (drop remainder or "sibling bit")
+               index /= 2;
             }
-            // parent address is index/2 (drop remainder or "sibling bit")
-            index /= 2;
+
+            if (++_input_index >= _size)
+               _input_index = 0;
+
+            return value;
          }
 
-         if (++_input_index >= _size)
-            _input_index = 0;
+      private:
 
-         return value;
-      }
+         std::size_t    _size;         // window size
+         std::size_t    _input_index;  // the actual sample placement is at (array_size + input_index);
+         std::vector<T> _data;         // the big array (twice array_size);
+      };
 
-   private:
+      template <typename T, typename Compare>
+      class fast_moving_extremum
+      {
+      public:
 
-      std::size_t    _size;         // window size
-      std::size_t    _input_index;  // the actual sample placement is at (array_size + input_index);
-      std::vector<T> _data;         // the big array (twice array_size);
-   };
+         fast_moving_extremum(duration d, float sps)
+          : fast_moving_extremum(std::size_t(as_float(d) * sps))
+         {}
+
+         fast_moving_extremum(std::size_t size)
+          : _size(std::max<std::size_t>(size, 1))
+          , _block(_size)
+          , _tails(_size + 1)
+         {
+            reset();
+         }
+
+         T operator()(T s)
+         {
+            T out;
+            process(&s, &out, 1);
+            return out;
+         }
+
+         void process(T const* in, T* out, std::size_t n)
+         {
+            auto const better = [](T a, T b) { return Compare{}(a, b)? a : b; };
+            auto* block = _block.data();
+            auto const* tails = _tails.data();
+            auto head = _head;
+            auto pos = _pos;
+            for (std::size_t i = 0; i != n;)
+            {
+               auto m = std::min(n - i, _size - pos);
+               for (std::size_t j = 0; j != m; ++j)
+               {
+                  // The window: the tail of the previous block after pos,
+                  // and the head of this one, up to pos.
+                  auto s = in[i + j];
+                  block[pos + j] = s;
+                  head = better(s, head);
+                  out[i + j] = better(tails[pos + j + 1], head);
+               }
+               i += m;
+               pos += m;
+               if (pos == _size)
+               {
+                  complete();
+                  head = extremum_identity<T, Compare>();
+                  pos = 0;
+               }
+            }
+            _head = head;
+            _pos = pos;
+         }
+
+         void reset()
+         {
+            std::fill(_tails.begin(), _tails.end(), extremum_identity<T, Compare>());
+            _head = extremum_identity<T, Compare>();
+            _pos = 0;
+         }
+
+         std::size_t size() const { return _size; }
+
+      private:
+
+         // The block is complete: the extrema of its tails, for the windows
+         // of the next block. The last, past the end, stays the identity.
+         void complete()
+         {
+            Compare better;
+            auto const* block = _block.data();
+            auto* tails = _tails.data();
+            auto tail = block[_size - 1];
+            tails[_size - 1] = tail;
+            for (std::size_t i = _size - 1; i-- != 0;)
+            {
+               if (better(block[i], tail))
+                  tail = block[i];
+               tails[i] = tail;
+            }
+         }
+
+         std::size_t    _size;         // window size
+         std::vector<T> _block;        // the current block
+         std::vector<T> _tails;        // the extrema of the previous block's tails
+         T              _head;         // the extremum of the current block so far
+         std::size_t    _pos;          // the position in the current block
+      };
+   }
 }
 
 #endif
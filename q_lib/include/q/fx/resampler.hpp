@@ -0,0 +1,297 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_RESAMPLER_HPP_OCTOBER_17_2026)
+#define CYCFI_Q_RESAMPLER_HPP_OCTOBER_17_2026
+
+#include <q/fx/fir.hpp>
+#include <q/utility/interpolation.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // resampler: streaming sample rate conversion, at any ratio (e.g. 44.1
+   // kHz to 48 kHz, or 96 kHz to 48 kHz), rational or not.
+   //
+   // process(in, n, out) consumes the n samples of in and writes the
+   // outputs that are due, returning how many. out must have room for
+   // max_output(n) samples. The outputs are aligned with the inputs:
+   // output j is the input signal at time j / ratio, in input samples,
+   // where ratio is out_sps / in_sps. Each output needs the inputs up to
+   // latency() samples ahead of it, so the last outputs of a stream are
+   // flushed by latency() more inputs (e.g. zeros).
+   //
+   // The quality selects the interpolation:
+   //
+   //    - linear and hermite use sample_interpolation::linear and
+   //      sample_interpolation::hermite (see interpolation.hpp). They are
+   //      cheap, with no anti-aliasing filter, for control signals and
+   //      previews, or for upsampling content with little high frequency.
+   //
+   //    - medium and high interpolate with a windowed-sinc (Kaiser) kernel
+   //      of 64 and 128 taps, with 90 dB and 110 dB of stopband rejection.
+   //      The stopband starts at the lower of the two Nyquist frequencies,
+   //      so downsampling does not alias. The passband ends at 0.41 x sps
+   //      (medium) and 0.44 x sps (high) of the lower rate: 19.7 and 21.3
+   //      kHz at 48 kHz. When downsampling, the kernel is widened by
+   //      in_sps / out_sps.
+   //
+   // The kernel is tabulated at 256 (medium) or 512 (high) phases per
+   // sample, in the manner of a polyphase filter bank. Each output is the
+   // dot product of the two phases that bracket its fractional position
+   // with the inputs (vectorized, see detail/dot_product.hpp), linearly
+   // interpolated. The table is computed once, at construction, and is
+   // immutable and reference counted: copies (e.g. one per channel) share
+   // it.
+   //
+   // ratio(r) changes the ratio while streaming, e.g. to correct the
+   // drift between two clocks. The kernel stays the one designed for the
+   // ratio given at construction: small changes are fine, but downsampling
+   // further than that ratio reduces the anti-aliasing margin.
+   ////////////////////////////////////////////////////////////////////////////
+   class resampler
+   {
+   public:
+
+      enum quality_type
+      {
+         linear
+       , hermite
+       , medium
+       , high
+      };
+
+                              resampler(double in_sps, double out_sps, quality_type quality = high);
+
+      std::size_t             process(float const* in, std::size_t n, float* out);
+      std::size_t             max_output(std::size_t n) const;
+      void                    reset();
+
+      double                  ratio() const        { return _ratio; }
+      void                    ratio(double r);
+
+      quality_type            quality() const      { return _quality; }
+      std::size_t             latency() const      { return _half; }
+
+   private:
+
+      template <typename Interpolate>
+      std::size_t             run(float* out, Interpolate&& interpolate);
+
+      float                   sinc(float const* x, double mu) const;
+
+      using table_ptr = std::shared_ptr<detail::aligned_vector<float> const>;
+
+      quality_type            _quality;
+      double                  _ratio;
+      double                  _step;         // input samples per output
+      std::size_t             _taps;         // the length of a phase
+      std::size_t             _half;         // the inputs needed ahead
+      std::size_t             _phases;
+      table_ptr               _table;
+      std::vector<float>      _buffer;
+      std::size_t             _end;          // the inputs in _buffer
+      double                  _time;         // the next output, in _buffer
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   namespace detail
+   {
+      // The inputs, newest first, as sample_interpolation expects
+      struct resampler_view
+      {
+         float operator[](std::size_t i) const { return newest[-std::ptrdiff_t(i)]; }
+         float const* newest;
+      };
+
+      // The phases of the windowed-sinc kernel, k(t), t in input samples,
+      // spanning taps samples: phase p, for fractional position mu = p /
+      // phases, holds k(j - (taps/2 - 1) - mu), for j from 0 to taps-1.
+      // There are phases + 1 phases: the last is the first, a sample
+      // later, so that every fractional position has a phase after it.
+      // Each phase is normalized for unity gain at DC.
+      inline detail::aligned_vector<float> resampler_table(
+         std::size_t taps, std::size_t phases, double cutoff, double attenuation)
+      {
+         auto const beta = kaiser_beta(attenuation);
+         auto const i0_beta = bessel_i0(beta);
+         auto const half = taps / 2.0;
+
+         detail::aligned_vector<float> table(taps * (phases + 1));
+         std::vector<double> h(taps);
+         for (std::size_t p = 0; p <= phases; ++p)
+         {
+            double sum = 0;
+            for (std::size_t j = 0; j != taps; ++j)
+            {
+               auto t = j - (half - 1) - double(p) / phases;
+               auto sinc = (t == 0)? 2 * cutoff : std::sin(2 * pi * cutoff * t) / (pi * t);
+               auto r = t / half;
+               auto w = bessel_i0(beta * std::sqrt(std::max(0.0, 1 - r * r))) / i0_beta;
+               h[j] = sinc * w;
+               sum += h[j];
+            }
+            for (std::size_t j = 0; j != taps; ++j)
+               table[p * taps + j] = float(h[j] / sum);
+         }
+         return table;
+      }
+   }
+
+   inline resampler::resampler(double in_sps, double out_sps, quality_type quality)
+    : _quality(quality)
+    , _end(0)
+   {
+#if __cpp_exceptions == 199711
+      if (!(in_sps > 0 && out_sps > 0))
+         throw std::runtime_error("Error: resampler sample rates must be positive.");
+#endif
+      ratio(out_sps / in_sps);
+
+      if (quality == linear || quality == hermite)
+      {
+         _taps = (quality == linear)? 2 : 4;
+         _half = _taps / 2;
+         _phases = 0;
+      }
+      else
+      {
+         // The base kernel, widened when downsampling. The transition band
+         // is what the taps afford at the attenuation (Kaiser's formula),
+         // ending at the lower Nyquist.
+         auto const attenuation = (quality == medium)? 90.0 : 110.0;
+         auto const base_taps = (quality == medium)? 64 : 128;
+         auto const scale = std::min(1.0, _ratio);
+         _taps = detail::simd_padded(std::size_t(std::ceil(base_taps / scale)));
+         _half = _taps / 2;
+         _phases = (quality == medium)? 256 : 512;
+
+         auto const transition = (attenuation - 7.95) / (2.285 * 2 * pi * (_taps - 1));
+         auto const cutoff = 0.5 * scale - transition / 2;
+         _table = std::make_shared<detail::aligned_vector<float> const>(
+            detail::resampler_table(_taps, _phases, cutoff, attenuation));
+      }
+
+      _buffer.resize(std::max<std::size_t>(8 * _taps, 4096));
+      reset();
+   }
+
+   inline void resampler::ratio(double r)
+   {
+#if __cpp_exceptions == 199711
+      if (!(r > 0))
+         throw std::runtime_error("Error: resampler ratio must be positive.");
+#endif
+      _ratio = r;
+      _step = 1.0 / r;
+   }
+
+   inline std::size_t resampler::max_output(std::size_t n) const
+   {
+      return std::size_t(std::ceil(n * _ratio)) + 1;
+   }
+
+   inline void resampler::reset()
+   {
+      // Start with a history of zeros, and the first output at the first
+      // input.
+      std::fill(_buffer.begin(), _buffer.end(), 0.0f);
+      _end = _taps;
+      _time = double(_taps);
+   }
+
+   inline float resampler::sinc(float const* x, double mu) const
+   {
+      auto const pos = mu * _phases;
+      auto const p = std::size_t(pos);
+      auto const f = float(pos - p);
+      auto const* h = _table->data() + p * _taps;
+      auto const y0 = detail::dot_product(h, x, _taps);
+      auto const y1 = detail::dot_product(h + _taps, x, _taps);
+      return y0 + f * (y1 - y0);
+   }
+
+   template <typename Interpolate>
+   inline std::size_t resampler::run(float* out, Interpolate&& interpolate)
+   {
+      // The outputs whose inputs, up to _half samples ahead, are in
+      auto const* buffer = _buffer.data();
+      auto time = _time;
+      std::size_t n = 0;
+      while (true)
+      {
+         auto const base = std::size_t(time);
+         if (base + _half >= _end)
+            break;
+         out[n++] = interpolate(buffer, base, time - base);
+         time += _step;
+      }
+      _time = time;
+      return n;
+   }
+
+   inline std::size_t resampler::process(float const* in, std::size_t n, float* out)
+   {
+      std::size_t count = 0;
+      while (n)
+      {
+         if (_end == _buffer.size())
+         {
+            // Keep the inputs from _taps samples before the next output
+            // (none, if the next output is past them)
+            auto const first = std::min(std::size_t(_time) - _taps, _end);
+            std::copy(_buffer.begin() + first, _buffer.begin() + _end, _buffer.begin());
+            _end -= first;
+            _time -= first;
+         }
+
+         auto const m = std::min(n, _buffer.size() - _end);
+         std::copy(in, in + m, _buffer.begin() + _end);
+         _end += m;
+         in += m;
+         n -= m;
+
+         switch (_quality)
+         {
+            case linear:
+               count += run(out + count,
+                  [this](float const* buffer, std::size_t base, double mu)
+                  {
+                     auto const x = detail::resampler_view{ buffer + base + _half };
+                     return sample_interpolation::linear{}(x, float(_half - mu));
+                  });
+               break;
+
+            case hermite:
+               count += run(out + count,
+                  [this](float const* buffer, std::size_t base, double mu)
+                  {
+                     auto const x = detail::resampler_view{ buffer + base + _half };
+                     return sample_interpolation::hermite{}(x, float(_half - mu));
+                  });
+               break;
+
+            default:
+               count += run(out + count,
+                  [this](float const* buffer, std::size_t base, double mu)
+                  {
+                     return sinc(buffer + base + 1 - _half, mu);
+                  });
+               break;
+         }
+      }
+      return count;
+   }
+}
+
+#endif
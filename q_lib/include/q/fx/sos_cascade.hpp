@@ -0,0 +1,409 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_SOS_CASCADE_HPP_OCTOBER_17_2026)
+#define CYCFI_Q_SOS_CASCADE_HPP_OCTOBER_17_2026
+
+#include <q/support/base.hpp>
+#include <q/support/frequency.hpp>
+#include <q/detail/biquad_block.hpp>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // sos_cascade: a cascade of second-order sections (biquads).
+   //
+   // The coefficients of all the sections are stored together, and so are
+   // their states, instead of in separate biquad objects. Each section is
+   // the recurrence of biquad, in direct form I:
+   //
+   //    y[k] = b0 x[k] + b1 x[k-1] + b2 x[k-2] - a1 y[k-1] - a2 y[k-2]
+   //
+   // A first-order section has b2 = a2 = 0.
+   //
+   // operator()(s) processes one sample through all the sections.
+   // process(in, out, n) processes a block section by section: the whole
+   // block through the first section, then through the second, and so on,
+   // with the block loops of biquad::process (see biquad_block.hpp), so
+   // the coefficients and the state of a section stay in registers for
+   // the whole block. in and out may be the same.
+   //
+   // The sections are set with config(i, b0, b1, b2, a1, a2), or by the
+   // designers below.
+   ////////////////////////////////////////////////////////////////////////////
+   struct sos_coefficients
+   {
+      float b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+   };
+
+   struct sos_state
+   {
+      float x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+   };
+
+   template <std::size_t Sections>
+   struct sos_cascade
+   {
+      static_assert(Sections >= 1, "sos_cascade needs at least one section");
+
+      static constexpr std::size_t sections = Sections;
+
+      float operator()(float s)
+      {
+         for (std::size_t i = 0; i != Sections; ++i)
+         {
+            auto const& c = coefs[i];
+            auto& z = states[i];
+            auto r = c.b0 * s + c.b1 * z.x1 + c.b2 * z.x2 - c.a1 * z.y1 - c.a2 * z.y2;
+            z.x2 = z.x1;
+            z.x1 = s;
+            z.y2 = z.y1;
+            z.y1 = r;
+            s = r;
+         }
+         return s;
+      }
+
+      void process(float const* in, float* out, std::size_t n)
+      {
+         for (std::size_t i = 0; i != Sections; ++i)
+         {
+            auto const& c = coefs[i];
+            auto& z = states[i];
+            std::size_t j = 0;
+#if defined(__SSE2__)
+            j = detail::biquad_block_sse(
+               c.b0, c.b1, c.b2, c.a1, c.a2, z.x1, z.x2, z.y1, z.y2, in, out, n
+            );
+#endif
+            detail::biquad_block_tdf2(
+               c.b0, c.b1, c.b2, c.a1, c.a2, z.x1, z.x2, z.y1, z.y2
+             , in + j, out + j, n - j
+            );
+            in = out;   // the next sections filter the output in place
+         }
+      }
+
+      void config(std::size_t i, float b0, float b1, float b2, float a1, float a2)
+      {
+         coefs[i] = { b0, b1, b2, a1, a2 };
+      }
+
+      void reset()
+      {
+         states = {};
+      }
+
+      std::array<sos_coefficients, Sections> coefs = {};
+      std::array<sos_state, Sections> states = {};
+   };
+
+   namespace detail
+   {
+      /////////////////////////////////////////////////////////////////////////
+      // Section designs, by the bilinear transform. omega is the digital
+      // frequency (2 pi f / sps) of the section. The second-order sections
+      // are those of config_lowpass and config_highpass (biquad.hpp), from
+      // the cosine and sine of omega, computed once for all the sections
+      // at the same frequency.
+      /////////////////////////////////////////////////////////////////////////
+      inline sos_coefficients sos_normalize(
+         double b0, double b1, double b2, double a0, double a1, double a2)
+      {
+         return {
+            float(b0 / a0), float(b1 / a0), float(b2 / a0)
+          , float(a1 / a0), float(a2 / a0)
+         };
+      }
+
+      inline sos_coefficients sos_lowpass2(double cos, double sin, double q)
+      {
+         auto alpha = sin / (2.0 * q);
+         return sos_normalize(
+            (1.0 - cos) / 2.0, 1.0 - cos, (1.0 - cos) / 2.0
+          , 1.0 + alpha, -2.0 * cos, 1.0 - alpha
+         );
+      }
+
+      inline sos_coefficients sos_highpass2(double cos, double sin, double q)
+      {
+         auto alpha = sin / (2.0 * q);
+         return sos_normalize(
+            (1.0 + cos) / 2.0, -(1.0 + cos), (1.0 + cos) / 2.0
+          , 1.0 + alpha, -2.0 * cos, 1.0 - alpha
+         );
+      }
+
+      // First order, from k = tan(omega / 2)
+      inline sos_coefficients sos_lowpass1(double k)
+      {
+         return sos_normalize(k, k, 0.0, k + 1.0, k - 1.0, 0.0);
+      }
+
+      inline sos_coefficients sos_highpass1(double k)
+      {
+         return sos_normalize(1.0, -1.0, 0.0, k + 1.0, k - 1.0, 0.0);
+      }
+
+      // The Q of the second-order section i of an N-th order Butterworth
+      inline double butterworth_q(std::size_t order, std::size_t i)
+      {
+         return 1.0 / (2.0 * std::sin(pi * (2*i + 1) / (2.0 * order)));
+      }
+
+      inline void scale(sos_coefficients& c, double gain)
+      {
+         c.b0 *= gain;
+         c.b1 *= gain;
+         c.b2 *= gain;
+      }
+
+      template <std::size_t Order, bool Highpass, typename Cascade>
+      inline void config_butterworth(Cascade& f, frequency freq, float sps)
+      {
+         auto omega = 2.0 * pi * as_double(freq) / sps;
+         auto cos = std::cos(omega);
+         auto sin = std::sin(omega);
+         for (std::size_t i = 0; i != Order / 2; ++i)
+         {
+            auto q = butterworth_q(Order, i);
+            f.coefs[i] = Highpass?
+               sos_highpass2(cos, sin, q) : sos_lowpass2(cos, sin, q);
+         }
+         if constexpr (Order % 2)
+         {
+            auto k = std::tan(omega / 2);
+            f.coefs[Order / 2] = Highpass? sos_highpass1(k) : sos_lowpass1(k);
+         }
+      }
+
+      template <std::size_t Order, bool Highpass, typename Cascade>
+      inline void config_chebyshev(Cascade& f, frequency freq, float sps, double ripple)
+      {
+         // The analog prototype's poles are on an ellipse. Pole pair i, at
+         // -sigma +/- jw, is a second-order section of natural frequency
+         // w0 = |sigma + jw| and Q = w0 / (2 sigma), scaled to the cutoff
+         // (or inverted, for highpass) and prewarped.
+         auto eps = std::sqrt(std::pow(10.0, ripple / 10.0) - 1.0);
+         auto mu = std::asinh(1.0 / eps) / Order;
+         auto wc = std::tan(pi * as_double(freq) / sps);
+
+         for (std::size_t i = 0; i != Order / 2; ++i)
+         {
+            auto theta = pi * (2*i + 1) / (2.0 * Order);
+            auto sigma = std::sinh(mu) * std::sin(theta);
+            auto w = std::cosh(mu) * std::cos(theta);
+            auto w0 = std::sqrt(sigma * sigma + w * w);
+            auto q = w0 / (2.0 * sigma);
+            auto omega = 2.0 * std::atan(Highpass? wc / w0 : wc * w0);
+            f.coefs[i] = Highpass?
+               sos_highpass2(std::cos(omega), std::sin(omega), q) :
+               sos_lowpass2(std::cos(omega), std::sin(omega), q);
+         }
+
+         if constexpr (Order % 2)
+         {
+            // The real pole, at -sinh(mu)
+            auto s = std::sinh(mu);
+            f.coefs[Order / 2] = Highpass?
+               sos_highpass1(wc / s) : sos_lowpass1(wc * s);
+         }
+         else
+         {
+            // Even orders: the passband ripples between -ripple and 0 dB
+            scale(f.coefs[0], 1.0 / std::sqrt(1.0 + eps * eps));
+         }
+      }
+
+      template <std::size_t Order, bool Highpass, typename Cascade>
+      inline void config_linkwitz_riley(Cascade& f, frequency freq, float sps)
+      {
+         // Two Butterworth filters of half the order in cascade: each
+         // Butterworth section twice. The two first-order sections of an
+         // odd half order make a second-order section with Q = 0.5.
+         constexpr auto half = Order / 2;
+         auto omega = 2.0 * pi * as_double(freq) / sps;
+         auto cos = std::cos(omega);
+         auto sin = std::sin(omega);
+         for (std::size_t i = 0; i != half / 2; ++i)
+         {
+            auto q = butterworth_q(half, i);
+            f.coefs[2*i] = f.coefs[2*i + 1] = Highpass?
+               sos_highpass2(cos, sin, q) : sos_lowpass2(cos, sin, q);
+         }
+         if constexpr (half % 2)
+         {
+            f.coefs[Order / 2 - 1] = Highpass?
+               sos_highpass2(cos, sin, 0.5) : sos_lowpass2(cos, sin, 0.5);
+
+            // Orders 2, 6, 10...: the lowpass and highpass outputs are in
+            // opposite phase at the crossover. Invert the highpass so they
+            // sum to an allpass.
+            if constexpr (Highpass)
+               scale(f.coefs[0], -1.0);
+         }
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Butterworth low pass and high pass filters of the given order: -3 dB
+   // at f, maximally flat passband, order x 6 dB per octave. Order / 2
+   // second-order sections, plus a first-order section for odd orders.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t Order>
+   struct butterworth_lowpass : sos_cascade<(Order + 1) / 2>
+   {
+      static_assert(Order >= 1, "Order must be at least 1");
+
+      butterworth_lowpass(frequency f, float sps)
+      {
+         config(f, sps);
+      }
+
+      void config(frequency f, float sps)
+      {
+         detail::config_butterworth<Order, false>(*this, f, sps);
+      }
+   };
+
+   template <std::size_t Order>
+   struct butterworth_highpass : sos_cascade<(Order + 1) / 2>
+   {
+      static_assert(Order >= 1, "Order must be at least 1");
+
+      butterworth_highpass(frequency f, float sps)
+      {
+         config(f, sps);
+      }
+
+      void config(frequency f, float sps)
+      {
+         detail::config_butterworth<Order, true>(*this, f, sps);
+      }
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Chebyshev (type I) low pass and high pass filters of the given order:
+   // a steeper transition than Butterworth, for a ripple in the passband.
+   // The gain ripples between -ripple and 0 dB in the passband, and is
+   // -ripple dB at f, the passband edge.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t Order>
+   struct chebyshev_lowpass : sos_cascade<(Order + 1) / 2>
+   {
+      static_assert(Order >= 1, "Order must be at least 1");
+
+      chebyshev_lowpass(frequency f, float sps, double ripple = 1.0)
+      {
+         config(f, sps, ripple);
+      }
+
+      void config(frequency f, float sps, double ripple = 1.0)
+      {
+         detail::config_chebyshev<Order, false>(*this, f, sps, ripple);
+      }
+   };
+
+   template <std::size_t Order>
+   struct chebyshev_highpass : sos_cascade<(Order + 1) / 2>
+   {
+      static_assert(Order >= 1, "Order must be at least 1");
+
+      chebyshev_highpass(frequency f, float sps, double ripple = 1.0)
+      {
+         config(f, sps, ripple);
+      }
+
+      void config(frequency f, float sps, double ripple = 1.0)
+      {
+         detail::config_chebyshev<Order, true>(*this, f, sps, ripple);
+      }
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Linkwitz-Riley low pass and high pass filters of the given (even)
+   // order, for crossovers: -6 dB at f, and the low pass and high pass
+   // outputs of the same order and frequency sum to a flat magnitude
+   // response (an allpass). linkwitz_riley_crossover splits a signal into
+   // the two bands.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t Order>
+   struct linkwitz_riley_lowpass : sos_cascade<Order / 2>
+   {
+      static_assert(Order >= 2 && Order % 2 == 0, "Order must be even");
+
+      linkwitz_riley_lowpass(frequency f, float sps)
+      {
+         config(f, sps);
+      }
+
+      void config(frequency f, float sps)
+      {
+         detail::config_linkwitz_riley<Order, false>(*this, f, sps);
+      }
+   };
+
+   template <std::size_t Order>
+   struct linkwitz_riley_highpass : sos_cascade<Order / 2>
+   {
+      static_assert(Order >= 2 && Order % 2 == 0, "Order must be even");
+
+      linkwitz_riley_highpass(frequency f, float sps)
+      {
+         config(f, sps);
+      }
+
+      void config(frequency f, float sps)
+      {
+         detail::config_linkwitz_riley<Order, true>(*this, f, sps);
+      }
+   };
+
+   template <std::size_t Order>
+   struct linkwitz_riley_crossover
+   {
+      linkwitz_riley_crossover(frequency f, float sps)
+       : lp(f, sps)
+       , hp(f, sps)
+      {}
+
+      void config(frequency f, float sps)
+      {
+         lp.config(f, sps);
+         hp.config(f, sps);
+      }
+
+      // Split n samples of in into low and high. in may be the same as
+      // either output.
+      void process(float const* in, float* low, float* high, std::size_t n)
+      {
+         if (in == high)
+         {
+            lp.process(in, low, n);
+            hp.process(in, high, n);
+         }
+         else
+         {
+            hp.process(in, high, n);
+            lp.process(in, low, n);
+         }
+      }
+
+      void reset()
+      {
+         lp.reset();
+         hp.reset();
+      }
+
+      linkwitz_riley_lowpass<Order> lp;
+      linkwitz_riley_highpass<Order> hp;
+   };
+}
+
+#endif
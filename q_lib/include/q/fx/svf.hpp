@@ -113,6 +113,14 @@ namespace cycfi::q
          update();
       }
 
+      // Set the prewarped cutoff coefficient g = tan(pi*fc/fs) directly,
+      // e.g. from a cutoff_table (q/fx/cutoff_table.hpp), skipping the tan.
+      void cutoff(float g)
+      {
+         _g = g;
+         update();
+      }
+
       // Set resonance by the exact quality factor Q.
       void resonance(double q)
       {
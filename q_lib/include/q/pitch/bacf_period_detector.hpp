@@ -11,13 +11,53 @@
 #include <q/utility/zero_crossing_collector.hpp>
 #include <q/utility/bitstream_acf.hpp>
 #include <q/fx/envelope.hpp>
+#include <infra/iterator_range.hpp>
+#include <array>
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 
 namespace cycfi::q
 {
    ////////////////////////////////////////////////////////////////////////////
-   class bacf_period_detector
+   // bacf_period_detector: the function call operator processes one sample
+   // and runs the analysis when a window becomes ready. The two phases are
+   // also available separately: collect(s) runs the zero-crossing scan and
+   // returns true when a window is ready, and analyze() builds the bitstream
+   // and autocorrelates it. analyze() must be called before the next
+   // collect(s) if the window is to be analyzed at all, because the next
+   // sample shifts the window. Splitting the phases lets the scan stay on
+   // the audio thread while the analysis runs elsewhere (see
+   // multi_pitch_detector). collect(in, n) is the block form of the scan:
+   // it processes samples until a window is ready or the samples run out,
+   // and returns the number of samples processed.
+   //
+   // process(in, n) runs a block of n samples through the same two phases:
+   // the zero-crossing scan in a tight loop, dropping into the analysis only
+   // at ready frames. It returns the frames (indices into in) where a new
+   // analysis completed. The returned range is valid until the next call to
+   // process. An optional function object, on_ready(frame), is called right
+   // after each analysis, for clients that need the intermediate results of
+   // a block with more than one ready frame.
+   //
+   // overlap sets how many analyses run per window length (see
+   // zero_crossing_collector). The default, 2, analyzes every half window.
+   // Higher overlaps give lower latency, at the cost of an analysis per
+   // hop. The bitstream is updated incrementally across hops: only the
+   // bits of the new hop (and of pulses that crossed the threshold) are
+   // written.
+   //
+   // The Window policy (see zero_crossing_collector) decides where the
+   // window size comes from and how the edges, the bitstream and the ready
+   // frames are stored. bacf_period_detector sizes them at run time, given
+   // lowest_freq and sps. basic_bacf_period_detector<static_window<W>> fixes
+   // them at compile time, allocates no memory, and has the bitstream
+   // autocorrelation loops run for a compile-time number of words. Its
+   // list of ready frames keeps only the first few of a block, though
+   // on_ready still sees them all.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename Window = dynamic_window>
+   class basic_bacf_period_detector
    {
    public:
 
@@ -25,31 +65,47 @@ namespace cycfi::q
       static constexpr float harmonic_periodicity_factor = 16;
       static constexpr float periodicity_diff_factor = 0.008;
 
+      using ready_frames = iterator_range<std::size_t const*>;
+      using window_type = Window;
+      using collector_type = basic_zero_crossing_collector<Window>;
+      using bits_type = bitset<natural_uint, typename Window::bits_storage>;
+      using acf_type = bitstream_acf<natural_uint, typename Window::bits_storage>;
+
       struct info
       {
          float                _period = -1;
          float                _periodicity = 0.0f;
       };
 
-                              bacf_period_detector(
+                              basic_bacf_period_detector(
                                  frequency lowest_freq
                                , frequency highest_freq
                                , float sps
                                , decibel hysteresis
+                               , std::size_t overlap = collector_type::default_overlap
                               );
 
-                              bacf_period_detector(bacf_period_detector const& rhs) = default;
-                              bacf_period_detector(bacf_period_detector&& rhs) = default;
-      bacf_period_detector&        operator=(bacf_period_detector const& rhs) = default;
-      bacf_period_detector&        operator=(bacf_period_detector&& rhs) = default;
+                              basic_bacf_period_detector(basic_bacf_period_detector const& rhs) = default;
+                              basic_bacf_period_detector(basic_bacf_period_detector&& rhs) = default;
+      basic_bacf_period_detector& operator=(basic_bacf_period_detector const& rhs) = default;
+      basic_bacf_period_detector& operator=(basic_bacf_period_detector&& rhs) = default;
 
       bool                    operator()(float s);
       bool                    operator()() const;
 
+      bool                    collect(float s);
+      std::size_t             collect(float const* in, std::size_t n);
+      void                    analyze();
+
+      ready_frames            process(float const* in, std::size_t n);
+
+      template <typename F>
+      ready_frames            process(float const* in, std::size_t n, F&& on_ready);
+
       bool                    is_ready() const        { return _zc.is_ready(); }
       std::size_t const       minimum_period() const  { return _min_period; }
-      bitset<> const&         bits() const            { return _bits; }
-      zero_crossing_collector const&    edges() const           { return _zc; }
+      bits_type const&        bits() const            { return _bits; }
+      collector_type const&   edges() const           { return _zc; }
       float                   predict_period() const;
 
       info const&             fundamental() const     { return _fundamental; }
@@ -57,40 +113,72 @@ namespace cycfi::q
 
    private:
 
+      // Counts of the low lags, [_min_period, low_lags_end), scored in one
+      // pass of the multi-lag kernel when the first candidate period below
+      // low_period_search needs its minimum searched. Valid for one frame.
+      static constexpr std::size_t low_period_search = 32;
+      static constexpr std::size_t low_lags_end = bitset<>::value_size;
+
+      struct low_lags
+      {
+         std::size_t          count(acf_type const& ac, std::size_t lag);
+
+         std::size_t          _first;
+         std::size_t          _last;
+         bool                 _ready = false;
+         std::array<std::size_t, low_lags_end> _counts;
+      };
+
+      void                    add_ready_frame(std::size_t frame);
       void                    set_bitstream();
       void                    autocorrelate();
-      int                     autocorrelate(bitstream_acf<> const& ac, std::size_t& period, bool first) const;
+      int                     autocorrelate(
+                                 acf_type const& ac, low_lags& lags
+                               , std::size_t& period, bool first) const;
 
-      zero_crossing_collector           _zc;
+      collector_type          _zc;
       info                    _fundamental;
       std::size_t             _min_period;
       int                     _range;
-      bitset<>                _bits;
+      bits_type               _bits;
       float                   _weight;
       std::size_t             _mid_point;
       float                   _period_diff_threshold;
       mutable float           _predicted_period = -1.0f;
       std::size_t             _edge_mark = 0;
       mutable std::size_t     _predict_edge = 0;
+      float                   _bits_threshold = 0.0f;
+      std::size_t             _bits_epoch = std::size_t(-1);
+      std::size_t             _bits_hop = 0;
+      typename Window::frames_storage _ready_frames;
+      std::size_t             _num_ready_frames = 0;
    };
 
+   using bacf_period_detector = basic_bacf_period_detector<>;
+
    ////////////////////////////////////////////////////////////////////////////
    // Implementation
    ////////////////////////////////////////////////////////////////////////////
-   inline bacf_period_detector::bacf_period_detector(
+   template <typename Window>
+   inline basic_bacf_period_detector<Window>::basic_bacf_period_detector(
       frequency lowest_freq
     , frequency highest_freq
     , float sps
     , decibel hysteresis
+    , std::size_t overlap
    )
-    : _zc(hysteresis, as_float(lowest_freq.period() * 2) * sps)
+    : _zc(hysteresis, as_float(lowest_freq.period() * 2) * sps, overlap)
     , _min_period(as_float(highest_freq.period()) * sps)
     , _range(as_float(highest_freq) / as_float(lowest_freq))
-    , _bits(_zc.window_size())
+    , _bits(detail::make_sized<bits_type>(_zc.window_size()))
     , _weight(2.0 / _zc.window_size())
     , _mid_point(_zc.window_size() / 2)
     , _period_diff_threshold(_mid_point * periodicity_diff_factor)
    {
+      // Room for the ready frames of a few windows per block
+      if constexpr (detail::resizable_container<decltype(_ready_frames)>::value)
+         _ready_frames.resize(16);
+
 #if __cpp_exceptions == 199711
       if (highest_freq <= lowest_freq)
          throw std::runtime_error(
@@ -99,27 +187,76 @@ namespace cycfi::q
 #endif
    }
 
-   inline void bacf_period_detector::set_bitstream()
+   template <typename Window>
+   inline void basic_bacf_period_detector<Window>::add_ready_frame(std::size_t frame)
+   {
+      if constexpr (detail::resizable_container<decltype(_ready_frames)>::value)
+      {
+         if (_num_ready_frames == _ready_frames.size())
+            _ready_frames.resize(_ready_frames.size() * 2);
+      }
+      if (_num_ready_frames != _ready_frames.size())
+         _ready_frames[_num_ready_frames++] = frame;
+   }
+
+   template <typename Window>
+   inline void basic_bacf_period_detector<Window>::set_bitstream()
    {
       auto threshold = _zc.peak_pulse() * pulse_threshold;
+      auto const hop = _zc.hop_size();
+      auto const first_new = int(_zc.window_size() - hop);
 
-      _bits.clear();
-      for (std::size_t i = 0; i != _zc.num_edges(); ++i)
+      auto rasterize = [this](auto const& info, bool val)
+      {
+         auto pos = std::max<int>(info._leading_edge, 0);
+         auto n = info._trailing_edge - pos;
+         _bits.set(pos, n, val);
+      };
+
+      if (_bits_epoch != _zc.num_resets() || _bits_hop + 1 != _zc.num_hops())
+      {
+         // The edges do not continue from the previously analyzed window.
+         // Rebuild the bitstream from scratch.
+         _bits.clear();
+         for (std::size_t i = 0; i != _zc.num_edges(); ++i)
+         {
+            auto const& info = _zc[i];
+            if (info._peak >= threshold)
+               rasterize(info, 1);
+         }
+      }
+      else
       {
-         auto const& info = _zc[i];
-         if (info._peak >= threshold)
+         // The edges were shifted by -hop since the previous window. Slide
+         // the bitstream the same way. Edges that end before the last hop
+         // are already in place; only those that reach into the new
+         // (cleared) hop need to be rasterized, plus any older edge that
+         // crossed the threshold, which moves with the peak pulse. Edges do
+         // not overlap, so writing the pulse's full run is safe.
+         _bits.slide(hop);
+         for (std::size_t i = 0; i != _zc.num_edges(); ++i)
          {
-            auto pos = std::max<int>(info._leading_edge, 0);
-            auto n = info._trailing_edge - pos;
-            _bits.set(pos, n, 1);
+            auto const& info = _zc[i];
+            bool val = info._peak >= threshold;
+            if (info._trailing_edge > first_new)
+               rasterize(info, val);
+            else if (val != (info._peak >= _bits_threshold))
+               rasterize(info, val);
          }
       }
+
+      _bits_threshold = threshold;
+      _bits_epoch = _zc.num_resets();
+      _bits_hop = _zc.num_hops();
    }
 
    namespace detail
    {
+      template <typename Detector>
       struct sub_collector
       {
+         using collector_type = typename Detector::collector_type;
+
          // Intermediate data structure for collecting autocorrelation results
          struct info
          {
@@ -130,10 +267,10 @@ namespace cycfi::q
             std::size_t       _harmonic;
          };
 
-         sub_collector(zero_crossing_collector const& zc, float period_diff_threshold, int range_)
+         sub_collector(collector_type const& zc, float period_diff_threshold, int range_)
           : _zc(zc)
           , _harmonic_threshold(
-               bacf_period_detector::harmonic_periodicity_factor*2 / zc.window_size())
+               Detector::harmonic_periodicity_factor*2 / zc.window_size())
           , _period_diff_threshold(period_diff_threshold)
           , _range(range_)
          {}
@@ -215,7 +352,7 @@ namespace cycfi::q
                save(incoming);
          };
 
-         void get(info const& info, bacf_period_detector::info& result)
+         void get(info const& info, typename Detector::info& result)
          {
             if (info._period != -1.0f)
             {
@@ -227,23 +364,40 @@ namespace cycfi::q
             }
             else
             {
-               result = bacf_period_detector::info{};
+               result = typename Detector::info{};
             }
          }
 
          float                   _first_period;
          info                    _fundamental;
-         zero_crossing_collector const&    _zc;
+         collector_type const&   _zc;
          float const             _harmonic_threshold;
          float const             _period_diff_threshold;
          int const               _range;
       };
    }
 
-   inline int bacf_period_detector::autocorrelate(bitstream_acf<> const& ac, std::size_t& period, bool first) const
+   template <typename Window>
+   inline std::size_t basic_bacf_period_detector<Window>::low_lags::count(
+      acf_type const& ac, std::size_t lag)
    {
-      auto count = ac(period);
-      auto mid = ac._mid_array * bitset<>::value_size;
+      if (lag < _first || lag >= _last)
+         return ac(lag);
+      if (!_ready)
+      {
+         ac(_first, _last, _counts.data());
+         _ready = true;
+      }
+      return _counts[lag - _first];
+   }
+
+   template <typename Window>
+   inline int basic_bacf_period_detector<Window>::autocorrelate(
+      acf_type const& ac, low_lags& lags
+    , std::size_t& period, bool first) const
+   {
+      auto count = lags.count(ac, period);
+      auto mid = ac._mid_array * bits_type::value_size;
       auto start = period;
 
       if (first && count == 0)   // make sure this is not a false correlation
@@ -251,12 +405,12 @@ namespace cycfi::q
          if (ac(period/2) == 0)  // oops false correlation!
             return -1;           // flag the return as a false correlation
       }
-      else if (period < 32) // Search minimum if the resolution is low
+      else if (period < low_period_search) // Search minimum if the resolution is low
       {
          // Search upwards for the minimum autocorrelation count
          for (auto p = start + 1; p < mid; ++p)
          {
-            auto c = ac(p);
+            auto c = lags.count(ac, p);
             if (c > count)
                break;
             count = c;
@@ -265,7 +419,7 @@ namespace cycfi::q
          // Search downwards for the minimum autocorrelation count
          for (auto p = start - 1; p > _min_period; --p)
          {
-            auto c = ac(p);
+            auto c = lags.count(ac, p);
             if (c > count)
                break;
             count = c;
@@ -275,14 +429,17 @@ namespace cycfi::q
       return count;
    }
 
-   inline void bacf_period_detector::autocorrelate()
+   template <typename Window>
+   inline void basic_bacf_period_detector<Window>::autocorrelate()
    {
       auto threshold = _zc.peak_pulse() * pulse_threshold;
 
       CYCFI_ASSERT(_zc.num_edges() > 1, "Not enough edges.");
 
-      bitstream_acf<> ac{ _bits };
-      detail::sub_collector collect{_zc, _period_diff_threshold, _range };
+      acf_type ac{ _bits };
+      detail::sub_collector<basic_bacf_period_detector> collect{_zc, _period_diff_threshold, _range };
+      auto const mid = ac._mid_array * bits_type::value_size;
+      low_lags lags{ _min_period, std::max(_min_period, std::min(low_lags_end, mid)), false, {} };
 
       [&]()
       {
@@ -301,7 +458,7 @@ namespace cycfi::q
                         break;
                      if (period >= _min_period)
                      {
-                        auto count = autocorrelate(ac, period, collect.empty());
+                        auto count = autocorrelate(ac, lags, period, collect.empty());
                         if (count == -1)
                            return; // Return early if we have a false correlation
                         float periodicity = 1.0f - (count * _weight);
@@ -319,7 +476,8 @@ namespace cycfi::q
       collect.get(collect._fundamental, _fundamental);
    }
 
-   inline bool bacf_period_detector::operator()(float s)
+   template <typename Window>
+   inline bool basic_bacf_period_detector<Window>::collect(float s)
    {
       // Zero crossing
       bool prev = _zc();
@@ -334,16 +492,83 @@ namespace cycfi::q
       if (_zc.is_reset())
          _fundamental = info{};
 
-      if (_zc.is_ready())
+      return _zc.is_ready();
+   }
+
+   template <typename Window>
+   inline std::size_t basic_bacf_period_detector<Window>::collect(float const* in, std::size_t n)
+   {
+      // The collector's block scan stops at every state change, window
+      // end and reset, which is all the bookkeeping here needs to see.
+      std::size_t i = 0;
+      while (i != n)
+      {
+         bool prev = _zc();
+         i += _zc(in + i, n - i);
+         bool zc = _zc();
+
+         if (!zc && prev != zc)
+         {
+            ++_edge_mark;
+            _predicted_period = -1.0f;
+         }
+
+         if (_zc.is_reset())
+            _fundamental = info{};
+
+         if (_zc.is_ready())
+            break;
+      }
+      return i;
+   }
+
+   template <typename Window>
+   inline void basic_bacf_period_detector<Window>::analyze()
+   {
+      set_bitstream();
+      autocorrelate();
+   }
+
+   template <typename Window>
+   inline bool basic_bacf_period_detector<Window>::operator()(float s)
+   {
+      if (collect(s))
       {
-         set_bitstream();
-         autocorrelate();
+         analyze();
          return true;
       }
       return false;
    }
 
-   inline float bacf_period_detector::harmonic(std::size_t index) const
+   template <typename Window>
+   template <typename F>
+   inline typename basic_bacf_period_detector<Window>::ready_frames
+   basic_bacf_period_detector<Window>::process(float const* in, std::size_t n, F&& on_ready)
+   {
+      _num_ready_frames = 0;
+      for (std::size_t i = 0; i != n;)
+      {
+         i += collect(in + i, n - i);
+         if (is_ready())
+         {
+            analyze();
+            add_ready_frame(i-1);
+            on_ready(i-1);
+         }
+      }
+      auto const* p = _ready_frames.data();
+      return { p, p + _num_ready_frames };
+   }
+
+   template <typename Window>
+   inline typename basic_bacf_period_detector<Window>::ready_frames
+   basic_bacf_period_detector<Window>::process(float const* in, std::size_t n)
+   {
+      return process(in, n, [](std::size_t) {});
+   }
+
+   template <typename Window>
+   inline float basic_bacf_period_detector<Window>::harmonic(std::size_t index) const
    {
       if (index > 0)
       {
@@ -353,7 +578,7 @@ namespace cycfi::q
          auto target_period = _fundamental._period / index;
          if (target_period >= _min_period && target_period < _mid_point)
          {
-            bitstream_acf<> ac{ _bits };
+            acf_type ac{ _bits };
             auto count = ac(std::round(target_period));
             float periodicity = 1.0f - (count * _weight);
             return periodicity;
@@ -362,12 +587,14 @@ namespace cycfi::q
       return 0.0f;
    }
 
-   inline bool bacf_period_detector::operator()() const
+   template <typename Window>
+   inline bool basic_bacf_period_detector<Window>::operator()() const
    {
       return _zc();
    }
 
-   inline float bacf_period_detector::predict_period() const
+   template <typename Window>
+   inline float basic_bacf_period_detector<Window>::predict_period() const
    {
       if (_predicted_period == -1.0f && _edge_mark != _predict_edge)
       {
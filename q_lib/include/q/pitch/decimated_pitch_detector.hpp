@@ -0,0 +1,188 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_DECIMATED_PITCH_DETECTOR_OCTOBER_17_2026)
+#define CYCFI_Q_DECIMATED_PITCH_DETECTOR_OCTOBER_17_2026
+
+#include <q/pitch/pitch_detector.hpp>
+#include <q/fx/fast_downsample.hpp>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // decimated_pitch_detector: the multi-rate form of pitch_detector, for
+   // low registers (e.g. bass) at high sample rates.
+   //
+   // The BACF window spans two periods of lowest_freq, so at 48 or 96 kHz
+   // a bass detector's window, bitstream and edge buffers are large, while
+   // the fundamental sits far below the Nyquist frequency. Here the input
+   // is first decimated by a power of two with a fast_downsample_cascade
+   // (a CIC-equivalent cascade of binomial halfband stages), and a
+   // pitch_detector runs at the reduced rate. The window, the bitstream and
+   // the edge buffers shrink by the decimation factor, and so do the number
+   // of samples scanned for zero crossings and the words correlated per lag.
+   //
+   // Periods are measured at the decimated rate, with the same sub-sample
+   // interpolation of the zero crossings, and the frequency is computed
+   // against the decimated rate, which is the same as scaling the period
+   // back to the input rate. The filter's constant group delay shifts all
+   // edges alike and does not affect the period.
+   //
+   // decimation_factor(lowest_freq, highest_freq, sps) picks the factor:
+   // the largest power of two, up to max_decimation, that keeps the
+   // decimated rate at least min_oversampling times highest_freq (so the
+   // highest fundamental keeps enough samples per period for accurate
+   // edges) and the window at least two words (128 frames) long. A factor
+   // of 1 (no decimation) is possible when the range reaches high enough.
+   //
+   // The function call operator and process(in, n) work as they do in
+   // pitch_detector. Ready frames are reported as indices into the input,
+   // at the input sample that completed the decimated sample.
+   ////////////////////////////////////////////////////////////////////////////
+   class decimated_pitch_detector
+   {
+   public:
+
+      static constexpr std::size_t max_decimation = 16;
+      static constexpr float min_oversampling = 16;
+
+      using decimator_type = fast_downsample_cascade<float>;
+      using ready_frames = pitch_detector::ready_frames;
+
+                              decimated_pitch_detector(
+                                 frequency lowest_freq
+                               , frequency highest_freq
+                               , float sps
+                               , decibel hysteresis
+                               , std::size_t overlap = zero_crossing_collector::default_overlap
+                              );
+
+      static std::size_t      decimation_factor(
+                                 frequency lowest_freq
+                               , frequency highest_freq
+                               , float sps
+                              );
+
+      bool                    operator()(float s);
+      ready_frames            process(float const* in, std::size_t n);
+
+      template <typename F>
+      ready_frames            process(float const* in, std::size_t n, F&& on_ready);
+
+      float                   get_frequency() const         { return _pd.get_frequency(); }
+      float                   predict_frequency(bool init = false) { return _pd.predict_frequency(init); }
+      bool                    is_note_shift() const         { return _pd.is_note_shift(); }
+      std::size_t             frames_after_shift() const    { return _pd.frames_after_shift(); }
+      float                   periodicity() const           { return _pd.periodicity(); }
+      void                    reset()                       { _pd.reset(); }
+
+      std::size_t             decimation() const            { return _decimator.factor(); }
+      float                   decimated_sps() const         { return _sps / decimation(); }
+      pitch_detector const&   get_pitch_detector() const    { return _pd; }
+
+   private:
+
+      static constexpr std::size_t block_size = 1024;
+
+      decimator_type          _decimator;
+      float                   _sps;
+      pitch_detector          _pd;
+      std::array<float, block_size> _block;
+      std::vector<std::size_t> _ready_frames;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   namespace detail
+   {
+      inline std::size_t ilog2(std::size_t n)
+      {
+         std::size_t r = 0;
+         while (n >>= 1)
+            ++r;
+         return r;
+      }
+   }
+
+   inline std::size_t decimated_pitch_detector::decimation_factor(
+      frequency lowest_freq
+    , frequency highest_freq
+    , float sps
+   )
+   {
+      auto const min_window = 2 * bitset<>::value_size;
+      std::size_t factor = 1;
+      while (factor < max_decimation)
+      {
+         auto rate = sps / (factor * 2);
+         if (rate < as_float(highest_freq) * min_oversampling)
+            break;
+         if (as_float(lowest_freq.period() * 2) * rate < min_window)
+            break;
+         factor *= 2;
+      }
+      return factor;
+   }
+
+   inline decimated_pitch_detector::decimated_pitch_detector(
+      frequency lowest_freq
+    , frequency highest_freq
+    , float sps
+    , decibel hysteresis
+    , std::size_t overlap
+   )
+    : _decimator{ detail::ilog2(decimation_factor(lowest_freq, highest_freq, sps)) }
+    , _sps{ sps }
+    , _pd{ lowest_freq, highest_freq, sps / _decimator.factor(), hysteresis, overlap }
+   {
+      // Room for the ready frames of a few windows per block
+      _ready_frames.reserve(16);
+   }
+
+   inline bool decimated_pitch_detector::operator()(float s)
+   {
+      return _decimator(s) && _pd(_decimator.out());
+   }
+
+   template <typename F>
+   inline decimated_pitch_detector::ready_frames
+   decimated_pitch_detector::process(float const* in, std::size_t n, F&& on_ready)
+   {
+      _ready_frames.clear();
+      auto const factor = decimation();
+      for (std::size_t i = 0; i != n;)
+      {
+         // Decimate a block. Output j completes at input first + j * factor.
+         auto first = i + (factor - 1 - _decimator.phase());
+         auto m = std::min(n - i, block_size);
+         auto num_out = _decimator(in + i, m, _block.data());
+         i += m;
+
+         _pd.process(_block.data(), num_out,
+            [&](std::size_t frame)
+            {
+               auto index = first + frame * factor;
+               _ready_frames.push_back(index);
+               on_ready(index);
+            }
+         );
+      }
+      auto const* p = _ready_frames.data();
+      return { p, p + _ready_frames.size() };
+   }
+
+   inline decimated_pitch_detector::ready_frames
+   decimated_pitch_detector::process(float const* in, std::size_t n)
+   {
+      return process(in, n, [](std::size_t) {});
+   }
+}
+
+#endif
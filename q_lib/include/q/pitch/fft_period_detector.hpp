@@ -0,0 +1,449 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_FFT_PERIOD_DETECTOR_OCTOBER_17_2026)
+#define CYCFI_Q_FFT_PERIOD_DETECTOR_OCTOBER_17_2026
+
+#include <q/pitch/pitch_detector.hpp>
+#include <q/fft/fft_plan.hpp>
+#include <infra/iterator_range.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // fft_period_detector: a period detector with the interface of
+   // bacf_period_detector (collect, analyze, process, fundamental,
+   // harmonic, predict_period), that autocorrelates the signal itself
+   // rather than its bitstream.
+   //
+   // The analysis computes the normalized square difference function (NSDF)
+   // of McLeod's MPM over the window (two periods of lowest_freq):
+   //
+   //    nsdf(t) = 2 r(t) / m(t)
+   //    r(t)    = sum(j < W/2) x(j) x(j+t)
+   //    m(t)    = sum(j < W/2) x(j)^2 + x(j+t)^2
+   //
+   // for all lags t at once, with one complex FFT and one inverse real FFT
+   // (the first half window and the whole window are packed into the real
+   // and imaginary parts of one transform), so the cost is O(W log W)
+   // regardless of the lag range. The transforms run on an fft_plan of
+   // the window's size, rounded up to a power of two. m(t) comes from running sums of squares.
+   // YIN's difference function is m(t) - 2 r(t), so the two differ only in
+   // the normalization. nsdf(t) is 1 for a perfectly periodic signal at its
+   // period, and within [-1, 1] in general.
+   //
+   // The period is the first key maximum (the highest peak of each
+   // positive region of the NSDF, past the zero-lag lobe) that is at least
+   // peak_threshold times the highest of them, refined with parabolic
+   // interpolation. Its value is the periodicity. harmonic(n) returns the
+   // NSDF at period/n.
+   //
+   // The zero_crossing_collector still sets the pace: the analysis is
+   // ready at the same frames as bacf_period_detector's, and edges() and
+   // predict_period() work the same. The window of samples itself is kept
+   // in a circular buffer.
+   //
+   // Unlike the bitstream, the NSDF keeps the amplitude information of the
+   // signal, which makes it more robust for polyphonic or noisy sources, at
+   // a higher cost per analysis.
+   ////////////////////////////////////////////////////////////////////////////
+   class fft_period_detector
+   {
+   public:
+
+      static constexpr float peak_threshold = 0.9f;
+
+      using ready_frames = iterator_range<std::size_t const*>;
+      using window_type = dynamic_window;
+      using collector_type = zero_crossing_collector;
+
+      struct info
+      {
+         float                _period = -1;
+         float                _periodicity = 0.0f;
+      };
+
+                              fft_period_detector(
+                                 frequency lowest_freq
+                               , frequency highest_freq
+                               , float sps
+                               , decibel hysteresis
+                               , std::size_t overlap = collector_type::default_overlap
+                              );
+
+      bool                    operator()(float s);
+      bool                    operator()() const      { return _zc(); }
+
+      bool                    collect(float s);
+      std::size_t             collect(float const* in, std::size_t n);
+      void                    analyze();
+
+      ready_frames            process(float const* in, std::size_t n);
+
+      template <typename F>
+      ready_frames            process(float const* in, std::size_t n, F&& on_ready);
+
+      bool                    is_ready() const        { return _zc.is_ready(); }
+      std::size_t const       minimum_period() const  { return _min_period; }
+      collector_type const&   edges() const           { return _zc; }
+      float                   predict_period() const;
+
+      info const&             fundamental() const     { return _fundamental; }
+      float                   harmonic(std::size_t index) const;
+
+      std::size_t             fft_size() const        { return _fft_size; }
+      float const*            nsdf() const            { return _nsdf.data(); }
+
+   private:
+
+      void                    push(float const* in, std::size_t n);
+      void                    compute_nsdf();
+      void                    pick_peak();
+
+      collector_type          _zc;
+      info                    _fundamental;
+      std::size_t             _min_period;
+      std::size_t             _window;
+      std::size_t             _fft_size;
+      fft_plan                _plan;
+      std::vector<float>      _history;
+      std::size_t             _write = 0;
+      std::vector<float>      _data;
+      std::vector<float>      _nsdf;
+      std::vector<float>      _energy;
+      std::vector<std::size_t> _ready_frames;
+
+      // Edge tracking for predict_period, as in bacf_period_detector
+      std::size_t             _edge_mark = 0;
+      mutable std::size_t     _predict_edge = 0;
+      mutable float           _predicted_period = -1.0f;
+   };
+
+   using fft_pitch_detector = basic_pitch_detector<dynamic_window, fft_period_detector>;
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   namespace detail
+   {
+      // The FFT size for a window of the given size, range checked
+      inline std::size_t fft_period_detector_size(std::size_t window)
+      {
+         auto fft_size = std::max<std::size_t>(smallest_pow2(window), 32);
+#if __cpp_exceptions == 199711
+         if (fft_size > 65536)
+            throw std::runtime_error(
+               "Error: lowest_freq is too low for the sample rate."
+            );
+#endif
+         return fft_size;
+      }
+
+      // The window of the zero crossing collector, in samples. The
+      // arguments are checked here, before anything is allocated.
+      inline float fft_period_detector_window(
+         frequency lowest_freq, frequency highest_freq, float sps)
+      {
+         auto window = as_float(lowest_freq.period() * 2) * sps;
+#if __cpp_exceptions == 199711
+         if (highest_freq <= lowest_freq)
+            throw std::runtime_error(
+               "Error: highest_freq <= lowest_freq."
+            );
+#endif
+         fft_period_detector_size(dynamic_window::size(std::uint32_t(window)));
+         return window;
+      }
+   }
+
+   inline fft_period_detector::fft_period_detector(
+      frequency lowest_freq
+    , frequency highest_freq
+    , float sps
+    , decibel hysteresis
+    , std::size_t overlap
+   )
+    : _zc(hysteresis, detail::fft_period_detector_window(lowest_freq, highest_freq, sps), overlap)
+    , _min_period(as_float(highest_freq.period()) * sps)
+    , _window(_zc.window_size())
+    , _fft_size(detail::fft_period_detector_size(_window))
+    , _plan(_fft_size)
+    , _history(_window, 0.0f)
+    , _data(_fft_size * 2)
+    , _nsdf(_window / 2 + 1)
+    , _energy(_window + 1)
+   {
+      // Room for the ready frames of a few windows per block
+      _ready_frames.reserve(16);
+   }
+
+   inline void fft_period_detector::push(float const* in, std::size_t n)
+   {
+      while (n)
+      {
+         auto m = std::min(n, _window - _write);
+         std::copy(in, in + m, _history.begin() + _write);
+         _write = (_write + m == _window)? 0 : _write + m;
+         in += m;
+         n -= m;
+      }
+   }
+
+   inline bool fft_period_detector::collect(float s)
+   {
+      push(&s, 1);
+
+      // Zero crossing
+      bool prev = _zc();
+      bool zc = _zc(s);
+
+      if (!zc && prev != zc)
+      {
+         ++_edge_mark;
+         _predicted_period = -1.0f;
+      }
+
+      if (_zc.is_reset())
+         _fundamental = info{};
+
+      return _zc.is_ready();
+   }
+
+   inline std::size_t fft_period_detector::collect(float const* in, std::size_t n)
+   {
+      std::size_t i = 0;
+      while (i != n)
+      {
+         bool prev = _zc();
+         auto k = _zc(in + i, n - i);
+         push(in + i, k);
+         i += k;
+         bool zc = _zc();
+
+         if (!zc && prev != zc)
+         {
+            ++_edge_mark;
+            _predicted_period = -1.0f;
+         }
+
+         if (_zc.is_reset())
+            _fundamental = info{};
+
+         if (_zc.is_ready())
+            break;
+      }
+      return i;
+   }
+
+   inline void fft_period_detector::compute_nsdf()
+   {
+      auto const half = _window / 2;
+      auto* d = _data.data();
+
+      // Pack the first half window (real part) and the whole window
+      // (imaginary part), oldest sample first, zero padded.
+      std::fill(_data.begin(), _data.end(), 0.0f);
+      _energy[0] = 0.0f;
+      for (std::size_t j = 0; j != _window; ++j)
+      {
+         auto x = _history[(_write + j) % _window];
+         if (j < half)
+            d[2*j] = x;
+         d[2*j+1] = x;
+         _energy[j+1] = _energy[j] + x * x;
+      }
+
+      _plan.fft(d);
+
+      // Unpack the two spectra, A (first half) and X (whole window), and
+      // form the cross spectrum conj(A) X, whose inverse is r(t). r(t) is
+      // real, so bins 0 to n/2 are packed in rfft's layout for irfft. The
+      // packed bin k goes to Z[k]'s slots, and Z[n-k] (k < n/2) is above
+      // them, so the packing is in place.
+      auto const n = _fft_size;
+      for (std::size_t k = 0; k <= n / 2; ++k)
+      {
+         auto nk = (n - k) & (n - 1);
+         float zr = d[2*k], zi = d[2*k+1];
+         float wr = d[2*nk], wi = d[2*nk+1];
+
+         // A = (Z[k] + conj(Z[n-k])) / 2, X = (Z[k] - conj(Z[n-k])) / 2i
+         float ar = (zr + wr) * 0.5f, ai = (zi - wi) * 0.5f;
+         float xr = (zi + wi) * 0.5f, xi = (wr - zr) * 0.5f;
+
+         // conj(A) X. Bins 0 and n/2 are real.
+         float rr = ar * xr + ai * xi;
+         float ri = ar * xi - ai * xr;
+         if (k == 0)
+         {
+            d[0] = rr;
+         }
+         else if (k == n / 2)
+         {
+            d[1] = rr;
+         }
+         else
+         {
+            d[2*k] = rr;
+            d[2*k+1] = ri;
+         }
+      }
+
+      _plan.irfft(d);
+
+      auto const e0 = _energy[half];
+      for (std::size_t t = 0; t <= half; ++t)
+      {
+         auto m = e0 + (_energy[half + t] - _energy[t]);
+         _nsdf[t] = (m > 0.0f)? 2.0f * d[t] / m : 0.0f;
+      }
+   }
+
+   inline void fft_period_detector::pick_peak()
+   {
+      auto const half = _window / 2;
+      auto const* nsdf = _nsdf.data();
+
+      // Skip the zero-lag lobe
+      std::size_t t = 1;
+      while (t < half && nsdf[t] > 0.0f)
+         ++t;
+
+      // Collect the key maxima: the highest peak of each positive region
+      struct peak { std::size_t lag; float value; };
+      peak peaks[32];
+      std::size_t num_peaks = 0;
+      float highest = 0.0f;
+
+      while (t < half && num_peaks != 32)
+      {
+         while (t < half && nsdf[t] <= 0.0f)
+            ++t;
+         peak p = { 0, 0.0f };
+         for (; t < half && nsdf[t] > 0.0f; ++t)
+         {
+            if (t >= _min_period && nsdf[t] > p.value
+               && nsdf[t] >= nsdf[t-1] && nsdf[t] >= nsdf[t+1])
+               p = { t, nsdf[t] };
+         }
+         if (p.lag != 0)
+         {
+            peaks[num_peaks++] = p;
+            highest = std::max(highest, p.value);
+         }
+      }
+
+      _fundamental = info{};
+      for (std::size_t i = 0; i != num_peaks; ++i)
+      {
+         if (peaks[i].value >= highest * peak_threshold)
+         {
+            // Parabolic interpolation
+            auto lag = peaks[i].lag;
+            float a = nsdf[lag-1], b = nsdf[lag], c = nsdf[lag+1];
+            float den = a - 2*b + c;
+            float delta = (den != 0.0f)? 0.5f * (a - c) / den : 0.0f;
+            _fundamental._period = lag + delta;
+            _fundamental._periodicity = std::min(1.0f, b - 0.25f * (a - c) * delta);
+            break;
+         }
+      }
+   }
+
+   inline void fft_period_detector::analyze()
+   {
+      compute_nsdf();
+      pick_peak();
+   }
+
+   inline bool fft_period_detector::operator()(float s)
+   {
+      if (collect(s))
+      {
+         analyze();
+         return true;
+      }
+      return false;
+   }
+
+   template <typename F>
+   inline fft_period_detector::ready_frames
+   fft_period_detector::process(float const* in, std::size_t n, F&& on_ready)
+   {
+      _ready_frames.clear();
+      for (std::size_t i = 0; i != n;)
+      {
+         i += collect(in + i, n - i);
+         if (is_ready())
+         {
+            analyze();
+            _ready_frames.push_back(i-1);
+            on_ready(i-1);
+         }
+      }
+      auto const* p = _ready_frames.data();
+      return { p, p + _ready_frames.size() };
+   }
+
+   inline fft_period_detector::ready_frames
+   fft_period_detector::process(float const* in, std::size_t n)
+   {
+      return process(in, n, [](std::size_t) {});
+   }
+
+   inline float fft_period_detector::harmonic(std::size_t index) const
+   {
+      if (index > 0 && _fundamental._period != -1)
+      {
+         if (index == 1)
+            return _fundamental._periodicity;
+
+         auto target_period = _fundamental._period / index;
+         if (target_period >= _min_period && target_period < _window / 2)
+         {
+            auto i = std::size_t(target_period);
+            auto frac = target_period - i;
+            return _nsdf[i] + frac * (_nsdf[i+1] - _nsdf[i]);
+         }
+      }
+      return 0.0f;
+   }
+
+   inline float fft_period_detector::predict_period() const
+   {
+      if (_predicted_period == -1.0f && _edge_mark != _predict_edge)
+      {
+         _predict_edge = _edge_mark;
+         if (_zc.num_edges() > 1)
+         {
+            auto threshold = _zc.peak_pulse() * bacf_period_detector::pulse_threshold;
+            for (int i = _zc.num_edges()-1; i > 0; --i)
+            {
+               auto const& edge2 = _zc[i];
+               if (edge2._peak >= threshold)
+               {
+                  for (int j = i-1; j >= 0; --j)
+                  {
+                     auto const& edge1 = _zc[j];
+                     if (edge1.similar(edge2))
+                     {
+                        _predicted_period = edge1.fractional_period(edge2);
+                        return _predicted_period;
+                     }
+                  }
+               }
+            }
+         }
+      }
+      return _predicted_period;
+   }
+}
+
+#endif
@@ -0,0 +1,244 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_MULTI_PITCH_DETECTOR_OCTOBER_17_2026)
+#define CYCFI_Q_MULTI_PITCH_DETECTOR_OCTOBER_17_2026
+
+#include <q/pitch/pitch_detector.hpp>
+#include <q/support/multi_buffer.hpp>
+#include <q/utility/worker_pool.hpp>
+#include <infra/assert.hpp>
+#include <array>
+#include <utility>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // multi_pitch_detector: N pitch_detector channels (e.g. the six strings
+   // of a hexaphonic pickup) processed a block at a time.
+   //
+   // The channels live in one contiguous array, and the per-channel results
+   // (frequency, periodicity, note shift and the number of analyses in the
+   // last block) are kept in parallel arrays, structure-of-arrays style, so
+   // reading all channels after a block touches a few cache lines.
+   //
+   // Each block is processed in rounds. In each round, the zero-crossing
+   // scan (pitch_detector::collect) runs on the calling thread, through
+   // every channel in turn, until that channel's window becomes ready or
+   // its input runs out. Then the analysis of all the channels that became
+   // ready (pitch_detector::analyze: the bitstream and the autocorrelation,
+   // by far the more costly part) runs, fanned out over an optional
+   // worker_pool. The scan resumes where it stopped. A channel is ready at
+   // most once per half window, so a block takes one or two rounds for
+   // typical block sizes. The results are identical to feeding each
+   // pitch_detector one sample at a time.
+   //
+   // num_workers is the number of worker threads in addition to the
+   // calling thread. With zero workers (the default, and the only option
+   // when Q_DONT_USE_THREADS is defined) everything runs on the calling
+   // thread.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   class multi_pitch_detector : non_copyable
+   {
+   public:
+
+      static constexpr std::size_t num_channels = N;
+
+      using channels_array = std::array<pitch_detector, N>;
+      using frequency_array = std::array<frequency, N>;
+      template <typename T>
+      using array = std::array<T, N>;
+
+                              multi_pitch_detector(
+                                 frequency lowest_freq
+                               , frequency highest_freq
+                               , float sps
+                               , decibel hysteresis
+                               , std::size_t num_workers = 0
+                               , bool pin_workers = false
+                              );
+
+                              multi_pitch_detector(
+                                 frequency_array const& lowest_freq
+                               , frequency_array const& highest_freq
+                               , float sps
+                               , decibel hysteresis
+                               , std::size_t num_workers = 0
+                               , bool pin_workers = false
+                              );
+
+      void                    operator()(multi_buffer<float const> const& in);
+
+      std::size_t             size() const                           { return N; }
+      pitch_detector const&   operator[](std::size_t channel) const  { return _channels[channel]; }
+      pitch_detector&         operator[](std::size_t channel)        { return _channels[channel]; }
+
+      array<float> const&     frequencies() const                    { return _frequency; }
+      array<float> const&     periodicities() const                  { return _periodicity; }
+      array<bool> const&      note_shifts() const                    { return _note_shift; }
+      array<std::size_t> const& ready_counts() const                 { return _ready_count; }
+
+      float                   get_frequency(std::size_t channel) const  { return _frequency[channel]; }
+      float                   periodicity(std::size_t channel) const    { return _periodicity[channel]; }
+      bool                    is_note_shift(std::size_t channel) const  { return _note_shift[channel]; }
+      std::size_t             ready_count(std::size_t channel) const    { return _ready_count[channel]; }
+
+   private:
+
+      template <std::size_t... I>
+      static channels_array   make_channels(
+                                 frequency_array const& lowest_freq
+                               , frequency_array const& highest_freq
+                               , float sps
+                               , decibel hysteresis
+                               , std::index_sequence<I...>
+                              );
+
+      void                    analyze(std::size_t const* ready, std::size_t num_ready);
+
+      channels_array          _channels;
+      array<float>            _frequency;
+      array<float>            _periodicity;
+      array<bool>             _note_shift;
+      array<std::size_t>      _ready_count;
+#if !defined(Q_DONT_USE_THREADS)
+      worker_pool             _workers;
+#endif
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   template <std::size_t... I>
+   inline typename multi_pitch_detector<N>::channels_array
+   multi_pitch_detector<N>::make_channels(
+      frequency_array const& lowest_freq
+    , frequency_array const& highest_freq
+    , float sps
+    , decibel hysteresis
+    , std::index_sequence<I...>
+   )
+   {
+      return {{ pitch_detector{ lowest_freq[I], highest_freq[I], sps, hysteresis }... }};
+   }
+
+   namespace detail
+   {
+      template <std::size_t... I>
+      inline std::array<frequency, sizeof...(I)>
+      fill_frequency(frequency f, std::index_sequence<I...>)
+      {
+         return {{ ((void) I, f)... }};
+      }
+   }
+
+   template <std::size_t N>
+   inline multi_pitch_detector<N>::multi_pitch_detector(
+      frequency lowest_freq
+    , frequency highest_freq
+    , float sps
+    , decibel hysteresis
+    , std::size_t num_workers
+    , bool pin_workers
+   )
+    : multi_pitch_detector{
+         detail::fill_frequency(lowest_freq, std::make_index_sequence<N>{})
+       , detail::fill_frequency(highest_freq, std::make_index_sequence<N>{})
+       , sps, hysteresis, num_workers, pin_workers
+      }
+   {}
+
+   template <std::size_t N>
+   inline multi_pitch_detector<N>::multi_pitch_detector(
+      frequency_array const& lowest_freq
+    , frequency_array const& highest_freq
+    , float sps
+    , decibel hysteresis
+    , std::size_t num_workers
+    , bool pin_workers
+   )
+    : _channels{ make_channels(
+         lowest_freq, highest_freq, sps, hysteresis, std::make_index_sequence<N>{}) }
+#if !defined(Q_DONT_USE_THREADS)
+    , _workers{ num_workers, pin_workers }
+#endif
+   {
+#if defined(Q_DONT_USE_THREADS)
+      (void) num_workers;
+      (void) pin_workers;
+#endif
+      _frequency.fill(0.0f);
+      _periodicity.fill(0.0f);
+      _note_shift.fill(false);
+      _ready_count.fill(0);
+   }
+
+   template <std::size_t N>
+   inline void multi_pitch_detector<N>::analyze(
+      std::size_t const* ready, std::size_t num_ready)
+   {
+      auto task = [&](std::size_t i)
+      {
+         _channels[ready[i]].analyze();
+      };
+
+#if !defined(Q_DONT_USE_THREADS)
+      _workers.run(num_ready, task);
+#else
+      for (std::size_t i = 0; i != num_ready; ++i)
+         task(i);
+#endif
+
+      for (std::size_t i = 0; i != num_ready; ++i)
+         ++_ready_count[ready[i]];
+   }
+
+   template <std::size_t N>
+   inline void multi_pitch_detector<N>::operator()(multi_buffer<float const> const& in)
+   {
+      CYCFI_ASSERT(in.size() >= N, "Not enough input channels.");
+
+      auto const n = in.frames.size();
+      _ready_count.fill(0);
+
+      array<std::size_t> pos{};
+      array<std::size_t> ready;
+      for (;;)
+      {
+         // Scan each channel up to its next ready window
+         std::size_t num_ready = 0;
+         for (std::size_t ch = 0; ch != N; ++ch)
+         {
+            auto& pd = _channels[ch];
+            auto const* src = in[ch].begin();
+            if (auto i = pos[ch]; i != n)
+            {
+               pos[ch] = i + pd.collect(src + i, n - i);
+               if (pd.get_period_detector().is_ready())
+                  ready[num_ready++] = ch;
+            }
+         }
+
+         if (num_ready == 0)
+            break;
+
+         // Analyze the ready windows before their channels move on
+         analyze(ready.data(), num_ready);
+      }
+
+      for (std::size_t ch = 0; ch != N; ++ch)
+      {
+         auto const& pd = _channels[ch];
+         _frequency[ch] = pd.get_frequency();
+         _periodicity[ch] = pd.periodicity();
+         _note_shift[ch] = pd.is_note_shift();
+      }
+   }
+}
+
+#endif
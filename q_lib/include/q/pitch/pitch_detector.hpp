@@ -17,27 +17,77 @@
 
 namespace cycfi::q
 {
+   namespace detail
+   {
+      // The bitstream type of a period detector, or void if it has none
+      template <typename PeriodDetector>
+      struct bits_type_of { using type = void; };
+
+      template <typename PeriodDetector>
+         requires requires { typename PeriodDetector::bits_type; }
+      struct bits_type_of<PeriodDetector>
+      {
+         using type = typename PeriodDetector::bits_type;
+      };
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // pitch_detector: see bacf_period_detector for the two phases, collect
+   // and analyze(), and for the block API, process(in, n), which returns the
+   // frames where the frequency was updated.
+   //
+   // overlap is the number of analyses per window length, as in
+   // bacf_period_detector. Note that the frequency tracking heuristics
+   // count analyses, so they react in fewer samples with a higher overlap.
+   //
+   // The PeriodDetector does the analysis: basic_bacf_period_detector (the
+   // default) or fft_period_detector (see fft_pitch_detector). bits() is
+   // available only if it has a bitstream.
+   //
+   // The Window policy selects the storage, as in bacf_period_detector.
+   // pitch_detector sizes its window at run time. static_pitch_detector
+   // (below) fixes it at compile time and allocates no memory.
    ////////////////////////////////////////////////////////////////////////////
-   class pitch_detector
+   template <
+      typename Window = dynamic_window
+    , typename PeriodDetector = basic_bacf_period_detector<Window>
+   >
+   class basic_pitch_detector
    {
    public:
 
       static constexpr float  max_deviation = 0.90f;
       static constexpr float  min_periodicity = 0.8f;
 
-                              pitch_detector(
+      using window_type = Window;
+      using period_detector_type = PeriodDetector;
+      using ready_frames = typename period_detector_type::ready_frames;
+      using bits_type = typename detail::bits_type_of<period_detector_type>::type;
+      using collector_type = typename period_detector_type::collector_type;
+
+                              basic_pitch_detector(
                                  frequency lowest_freq
                                , frequency highest_freq
                                , float sps
                                , decibel hysteresis
+                               , std::size_t overlap = collector_type::default_overlap
                               );
 
-                              pitch_detector(pitch_detector const& rhs) = default;
-                              pitch_detector(pitch_detector&& rhs) = default;
-      pitch_detector&         operator=(pitch_detector const& rhs) = default;
-      pitch_detector&         operator=(pitch_detector&& rhs) = default;
+                              basic_pitch_detector(basic_pitch_detector const& rhs) = default;
+                              basic_pitch_detector(basic_pitch_detector&& rhs) = default;
+      basic_pitch_detector&   operator=(basic_pitch_detector const& rhs) = default;
+      basic_pitch_detector&   operator=(basic_pitch_detector&& rhs) = default;
 
       bool                    operator()(float s);
+      bool                    collect(float s)              { return _pd.collect(s); }
+      std::size_t             collect(float const* in, std::size_t n) { return _pd.collect(in, n); }
+      void                    analyze();
+
+      ready_frames            process(float const* in, std::size_t n);
+
+      template <typename F>
+      ready_frames            process(float const* in, std::size_t n, F&& on_ready);
+
       float                   get_frequency() const         { return _frequency; }
       float                   predict_frequency(bool init = false);
       bool                    is_note_shift() const;
@@ -45,19 +95,20 @@ namespace cycfi::q
       float                   periodicity() const;
       void                    reset()                       { _frequency = 0.0f; }
 
-      bitset<> const&         bits() const                  { return _pd.bits(); }
-      zero_crossing_collector const&    edges() const                 { return _pd.edges(); }
-      bacf_period_detector const& get_period_detector() const { return _pd; }
+      auto const&             bits() const                  { return _pd.bits(); }
+      collector_type const&   edges() const                 { return _pd.edges(); }
+      period_detector_type const& get_period_detector() const { return _pd; }
 
    private:
 
+      void                    update_frequency();
       float                   calculate_frequency() const;
       float                   bias(float current, float incoming, bool& shift);
       void                    bias(float incoming);
 
       using exp_moving_average_type = exp_moving_average<2>;
 
-      bacf_period_detector    _pd;
+      period_detector_type    _pd;
       float                   _frequency;
       median3                 _median;
       median3                 _predict_median;
@@ -65,21 +116,69 @@ namespace cycfi::q
       std::size_t             _frames_after_shift = 0;
    };
 
+   using pitch_detector = basic_pitch_detector<>;
+
+   ////////////////////////////////////////////////////////////////////////////
+   // static_pitch_detector: a pitch_detector for a detection range and
+   // sample rate known at compile time. The window size (derived from
+   // LowestHz and SPS exactly as pitch_detector does at run time) and all
+   // buffer capacities are constants, so all storage is in std::arrays
+   // within the object itself, which can be placed in static memory.
+   // Nothing is allocated. The results are identical to a pitch_detector
+   // constructed with the same range, sample rate and hysteresis.
+   ////////////////////////////////////////////////////////////////////////////
+   namespace detail
+   {
+      template <std::uint32_t LowestHz, std::uint32_t SPS>
+      constexpr std::uint32_t pitch_detector_window()
+      {
+         return as_float(frequency(double(LowestHz)).period() * 2) * SPS;
+      }
+   }
+
+   template <std::uint32_t LowestHz, std::uint32_t HighestHz, std::uint32_t SPS>
+   class static_pitch_detector
+    : public basic_pitch_detector<
+         static_window<detail::pitch_detector_window<LowestHz, SPS>()>>
+   {
+   public:
+
+      static_assert(LowestHz > 0 && HighestHz > LowestHz,
+         "Error: Invalid frequency range.");
+
+      using base_type = basic_pitch_detector<
+         static_window<detail::pitch_detector_window<LowestHz, SPS>()>>;
+
+      static constexpr std::size_t window_size = base_type::window_type::window_size;
+
+                              static_pitch_detector(
+                                 decibel hysteresis
+                               , std::size_t overlap = base_type::collector_type::default_overlap
+                              )
+                               : base_type{
+                                    frequency(double(LowestHz)), frequency(double(HighestHz))
+                                  , float(SPS), hysteresis, overlap }
+                              {}
+   };
+
    ////////////////////////////////////////////////////////////////////////////
    // Implementation
    ////////////////////////////////////////////////////////////////////////////
-   inline pitch_detector::pitch_detector(
+   template <typename Window, typename PeriodDetector>
+   inline basic_pitch_detector<Window, PeriodDetector>::basic_pitch_detector(
        q::frequency lowest_freq
      , q::frequency highest_freq
      , float sps
      , decibel hysteresis
+     , std::size_t overlap
    )
-     : _pd{ lowest_freq, highest_freq, sps, hysteresis }
+     : _pd{ lowest_freq, highest_freq, sps, hysteresis, overlap }
      , _frequency{ 0.0f }
      , _sps{ sps }
    {}
 
-   inline float pitch_detector::bias(float current, float incoming, bool& shift)
+   template <typename Window, typename PeriodDetector>
+   inline float basic_pitch_detector<Window, PeriodDetector>::bias(float current, float incoming, bool& shift)
    {
       auto error = current / 32; // approx 1/2 semitone
       auto diff = std::abs(current-incoming);
@@ -125,7 +224,8 @@ namespace cycfi::q
       return current;
    }
 
-   inline void pitch_detector::bias(float incoming)
+   template <typename Window, typename PeriodDetector>
+   inline void basic_pitch_detector<Window, PeriodDetector>::bias(float incoming)
    {
       auto current = _frequency;
       ++_frames_after_shift;
@@ -181,56 +281,94 @@ namespace cycfi::q
       }
    }
 
-   inline bool pitch_detector::operator()(float s)
+   template <typename Window, typename PeriodDetector>
+   inline void basic_pitch_detector<Window, PeriodDetector>::analyze()
    {
-      _pd(s);
+      _pd.analyze();
+      update_frequency();
+   }
 
-      if (_pd.is_ready())
+   template <typename Window, typename PeriodDetector>
+   inline void basic_pitch_detector<Window, PeriodDetector>::update_frequency()
+   {
+      if (_frequency == 0.0f)
       {
-         if (_frequency == 0.0f)
+         // Disregard if we are not periodic enough
+         if (_pd.fundamental()._periodicity >= max_deviation)
          {
-            // Disregard if we are not periodic enough
-            if (_pd.fundamental()._periodicity >= max_deviation)
+            auto f = calculate_frequency();
+            if (f > 0.0f)
             {
-               auto f = calculate_frequency();
-               if (f > 0.0f)
-               {
-                  _median(f);       // Apply the median for the future
-                  _frequency = f;   // But assign outright now
-                  _frames_after_shift = 0;
-               }
+               _median(f);       // Apply the median for the future
+               _frequency = f;   // But assign outright now
+               _frames_after_shift = 0;
             }
          }
-         else
+      }
+      else
+      {
+         if (_pd.fundamental()._periodicity < min_periodicity)
+            _frames_after_shift = 0;
+         auto f = calculate_frequency();
+         if (f > 0.0f)
+            bias(f);
+      }
+   }
+
+   template <typename Window, typename PeriodDetector>
+   inline bool basic_pitch_detector<Window, PeriodDetector>::operator()(float s)
+   {
+      if (collect(s))
+      {
+         analyze();
+         return true;
+      }
+      return false;
+   }
+
+   template <typename Window, typename PeriodDetector>
+   template <typename F>
+   inline typename basic_pitch_detector<Window, PeriodDetector>::ready_frames
+   basic_pitch_detector<Window, PeriodDetector>::process(float const* in, std::size_t n, F&& on_ready)
+   {
+      return _pd.process(in, n,
+         [&](std::size_t frame)
          {
-            if (_pd.fundamental()._periodicity < min_periodicity)
-               _frames_after_shift = 0;
-            auto f = calculate_frequency();
-            if (f > 0.0f)
-               bias(f);
+            update_frequency();
+            on_ready(frame);
          }
-      }
-      return _pd.is_ready();
+      );
+   }
+
+   template <typename Window, typename PeriodDetector>
+   inline typename basic_pitch_detector<Window, PeriodDetector>::ready_frames
+   basic_pitch_detector<Window, PeriodDetector>::process(float const* in, std::size_t n)
+   {
+      return process(in, n, [](std::size_t) {});
    }
 
-   inline float pitch_detector::calculate_frequency() const
+   template <typename Window, typename PeriodDetector>
+   inline float basic_pitch_detector<Window, PeriodDetector>::calculate_frequency() const
    {
       if (_pd.fundamental()._period != -1)
          return _sps / _pd.fundamental()._period;
       return 0.0f;
    }
 
-   inline float pitch_detector::periodicity() const
+   template <typename Window, typename PeriodDetector>
+   inline float basic_pitch_detector<Window, PeriodDetector>::periodicity() const
    {
       return _pd.fundamental()._periodicity;
    }
 
-   inline bool pitch_detector::is_note_shift() const
+   template <typename Window, typename PeriodDetector>
+   inline bool basic_pitch_detector<Window, PeriodDetector>::is_note_shift() const
    {
       return _frames_after_shift == 0;
    }
 
-   inline float pitch_detector::predict_frequency(bool init)
+   template <typename Window, typename PeriodDetector>
+   inline float basic_pitch_detector<Window, PeriodDetector>::predict_frequency(bool init)
    {
       auto period = _pd.predict_period();
       if (period < _pd.minimum_period())
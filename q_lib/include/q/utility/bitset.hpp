@@ -12,34 +12,43 @@
 #include <vector>
 #include <algorithm>
 #include <cstdint>
+#include <array>
 #include <q/support/base.hpp>
+#include <q/detail/init_store.hpp>
+#include <infra/assert.hpp>
 
 namespace cycfi::q
 {
    ////////////////////////////////////////////////////////////////////////////
    // The bitset class stores bits efficiently using integers <T>. Data is
-   // stored in a std::vector with a size that is fixed at construction time,
-   // given the number of bits required.
+   // stored in a std::vector (the default Storage) with a size that is
+   // fixed at construction time, given the number of bits required.
+   //
+   // Storage can also be a std::array<T, N>, for a bitset of N * value_size
+   // bits with no dynamic allocation. Such a bitset is default constructed.
    //
    // Member functions are provided for:
    //
    //    1. Setting individual bits and ranges of bits
    //    2. Geting each bit at position i
    //    3. Clearing all bits
-   //    4. Getting the actual integers that stores the bits.
+   //    4. Sliding the bits down by n positions (bit i+n moves to bit i)
+   //    5. Getting the actual integers that stores the bits.
    ////////////////////////////////////////////////////////////////////////////
-   template <typename T = natural_uint>
+   template <typename T = natural_uint, typename Storage = std::vector<T>>
    class bitset
    {
    public:
 
       using value_type = T;
-      using vector_type = std::vector<T>;
+      using storage_type = Storage;
+      using vector_type = Storage;
 
       static_assert(std::is_unsigned<T>::value, "T must be unsigned");
       static constexpr auto value_size = CHAR_BIT * sizeof(T);
       static constexpr auto one = T{1};
 
+                     bitset();
                      bitset(std::size_t num_bits);
                      bitset(bitset const& rhs) = default;
                      bitset(bitset&& rhs) = default;
@@ -52,39 +61,56 @@ namespace cycfi::q
       void           set(std::size_t i, bool val);
       void           set(std::size_t i, std::size_t n, bool val);
       bool           get(std::size_t i) const;
+      void           slide(std::size_t n);
 
       T*             data();
       T const*       data() const;
 
    private:
 
-      vector_type    _bits;
+      Storage        _bits;
    };
 
    ////////////////////////////////////////////////////////////////////////////
    // Implementation
    ////////////////////////////////////////////////////////////////////////////
-   template <typename T>
-   inline bitset<T>::bitset(std::size_t num_bits)
+   template <typename T, typename Storage>
+   inline bitset<T, Storage>::bitset()
+   {
+      static_assert(!detail::resizable_container<Storage>::value,
+         "Error: Not default constructible for resizable storage");
+      clear();
+   }
+
+   template <typename T, typename Storage>
+   inline bitset<T, Storage>::bitset(std::size_t num_bits)
    {
       auto array_size = (num_bits + value_size - 1) / value_size;
-      _bits.resize(array_size, 0);
+      if constexpr (detail::resizable_container<Storage>::value)
+      {
+         _bits.resize(array_size, 0);
+      }
+      else
+      {
+         CYCFI_ASSERT(array_size <= _bits.size(), "Storage is too small.");
+         clear();
+      }
    }
 
-   template <typename T>
-   inline std::size_t bitset<T>::size() const
+   template <typename T, typename Storage>
+   inline std::size_t bitset<T, Storage>::size() const
    {
       return _bits.size() * value_size;
    }
 
-   template <typename T>
-   inline void bitset<T>::clear()
+   template <typename T, typename Storage>
+   inline void bitset<T, Storage>::clear()
    {
       std::fill(_bits.begin(), _bits.end(), 0);
    }
 
-   template <typename T>
-   inline void bitset<T>::set(std::size_t i, bool val)
+   template <typename T, typename Storage>
+   inline void bitset<T, Storage>::set(std::size_t i, bool val)
    {
       // Check that we don't get past the storage
       if (i > size())
@@ -95,8 +121,8 @@ namespace cycfi::q
       ref ^= (-T(val) ^ ref) & mask;
    }
 
-   template <typename T>
-   inline bool bitset<T>::get(std::size_t i) const
+   template <typename T, typename Storage>
+   inline bool bitset<T, Storage>::get(std::size_t i) const
    {
       // Check we don't get past the storage
       if (i > size())
@@ -106,8 +132,8 @@ namespace cycfi::q
       return (_bits[i / value_size] & mask) != 0;
    }
 
-   template <typename T>
-   inline void bitset<T>::set(std::size_t i, std::size_t n, bool val)
+   template <typename T, typename Storage>
+   inline void bitset<T, Storage>::set(std::size_t i, std::size_t n, bool val)
    {
       // Check that the index (i) does not get past size
       auto size_ = size();
@@ -178,14 +204,45 @@ namespace cycfi::q
       }
    }
 
-   template <typename T>
-   inline T* bitset<T>::data()
+   template <typename T, typename Storage>
+   inline void bitset<T, Storage>::slide(std::size_t n)
+   {
+      // Move bit i+n to bit i, a word at a time, and clear the n vacated
+      // bits at the end.
+      auto const size_ = _bits.size();
+      auto const words = n / value_size;
+      if (words >= size_)
+      {
+         clear();
+         return;
+      }
+
+      auto* p = _bits.data();
+      auto const shift = n % value_size;
+      auto const last = size_ - words;
+      if (shift == 0)
+      {
+         // Word aligned: a plain copy
+         std::copy(p + words, p + size_, p);
+      }
+      else
+      {
+         // Otherwise, each word is made from two adjacent source words
+         for (std::size_t i = 0; i != last-1; ++i)
+            p[i] = (p[i+words] >> shift) | (p[i+words+1] << (value_size-shift));
+         p[last-1] = p[size_-1] >> shift;
+      }
+      std::fill(p + last, p + size_, 0);
+   }
+
+   template <typename T, typename Storage>
+   inline T* bitset<T, Storage>::data()
    {
       return _bits.data();
    }
 
-   template <typename T>
-   inline T const* bitset<T>::data() const
+   template <typename T, typename Storage>
+   inline T const* bitset<T, Storage>::data() const
    {
       return _bits.data();
    }
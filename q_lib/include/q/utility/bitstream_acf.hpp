@@ -8,8 +8,10 @@
 #define CYCFI_Q_AUTO_CORRELATOR_HPP_MARCH_12_2018
 
 #include <q/utility/bitset.hpp>
-#include <q/detail/count_bits.hpp>
+#include <q/detail/xor_count_bits.hpp>
 #include <q/support/base.hpp>
+#include <algorithm>
+#include <tuple>
 
 namespace cycfi::q
 {
@@ -38,46 +40,83 @@ namespace cycfi::q
    // After XOR, the number of bits (set to 1) is counted. The lower the
    // count, the higher the periodicity. A count of zero gives perfect
    // correlation: there is no mismatch.
+   //
+   // The function call operator scores a single lag. The range overload,
+   // ac(first, last, counts), scores every lag in [first, last) and is the
+   // one to use when many lags are needed: lags that share a word offset
+   // are evaluated together in a single pass over the bitset (see
+   // detail::xor_count_bits), vectorized with AVX2 or AVX-512 when the
+   // target supports it.
+   //
+   // With a fixed size bitset (std::array Storage), _mid_array, the number
+   // of words compared per lag, is a compile-time constant. The loops over
+   // the words then have constant trip counts that the compiler can unroll.
    ////////////////////////////////////////////////////////////////////////////
-   template <typename T = natural_uint>
-   struct bitstream_acf
+   namespace detail
+   {
+      constexpr std::size_t acf_mid_array(std::size_t num_words)
+      {
+         return std::max<std::size_t>((num_words / 2) - 1, 1);
+      }
+
+      template <typename Storage, bool = resizable_container<Storage>::value>
+      struct acf_mid_array_base
+      {
+         acf_mid_array_base(std::size_t num_words)
+          : _mid_array(acf_mid_array(num_words))
+         {}
+
+         std::size_t const _mid_array;
+      };
+
+      template <typename Storage>
+      struct acf_mid_array_base<Storage, false>
+      {
+         acf_mid_array_base(std::size_t /* num_words */)
+         {}
+
+         static constexpr std::size_t _mid_array =
+            acf_mid_array(std::tuple_size<Storage>::value);
+      };
+   }
+
+   template <typename T = natural_uint, typename Storage = std::vector<T>>
+   struct bitstream_acf : detail::acf_mid_array_base<Storage>
    {
-      static constexpr auto value_size = bitset<>::value_size;
+      using bitset_type = bitset<T, Storage>;
+      using detail::acf_mid_array_base<Storage>::_mid_array;
+
+      static constexpr auto value_size = bitset_type::value_size;
 
-      bitstream_acf(bitset<T> const& bits)
-         : _bits(bits)
-         , _mid_array(std::max<std::size_t>(((bits.size() / value_size) / 2) - 1, 1))
+      bitstream_acf(bitset_type const& bits)
+         : detail::acf_mid_array_base<Storage>(bits.size() / value_size)
+         , _bits(bits)
       {}
 
       std::size_t operator()(std::size_t pos) const
       {
-         auto const index = pos / value_size;
-         auto const shift = pos % value_size;
-
-         auto const* p1 = _bits.data();
-         auto const* p2 = _bits.data() + index;
-         auto count = 0;
+         std::size_t count;
+         detail::xor_count_bits(
+            _bits.data(), _bits.data() + (pos / value_size)
+          , _mid_array, pos % value_size, 1, &count);
+         return count;
+      };
 
-         if (shift == 0)
-         {
-            for (std::size_t i = 0; i != _mid_array; ++i)
-               count += detail::count_bits(*p1++ ^ *p2++);
-         }
-         else
+      void operator()(std::size_t first, std::size_t last, std::size_t* counts) const
+      {
+         while (first < last)
          {
-            auto shift2 = value_size - shift;
-            for (std::size_t i = 0; i != _mid_array; ++i)
-            {
-               auto v = *p2++ >> shift;
-               v |= *p2 << shift2;
-               count += detail::count_bits(*p1++ ^ v);
-            }
+            auto const shift = first % value_size;
+            auto const n = std::min<std::size_t>(last - first, value_size - shift);
+            detail::xor_count_bits(
+               _bits.data(), _bits.data() + (first / value_size)
+             , _mid_array, shift, n, counts);
+            first += n;
+            counts += n;
          }
-         return count;
-      };
+      }
 
-      bitset<T> const&     _bits;
-      std::size_t const    _mid_array;
+      bitset_type const&   _bits;
    };
 }
 
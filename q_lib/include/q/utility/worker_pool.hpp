@@ -0,0 +1,188 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#if !defined(CYCFI_Q_WORKER_POOL_OCTOBER_17_2026)
+#define CYCFI_Q_WORKER_POOL_OCTOBER_17_2026
+
+#if !defined(Q_DONT_USE_THREADS)
+
+#include <infra/support.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+# include <pthread.h>
+# include <sched.h>
+#endif
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // worker_pool: a small fixed set of threads for fork-join work.
+   //
+   // run(n, f) calls f(i) for every i in [0, n), spread over the workers
+   // and the calling thread, and returns when all calls are done. Indices
+   // are handed out one at a time, so uneven items balance out. No memory
+   // is allocated after construction.
+   //
+   // With zero workers, run(n, f) simply calls f(i) in order on the calling
+   // thread.
+   //
+   // If pin is true, worker k is pinned to CPU k+1 (modulo the number of
+   // CPUs), leaving CPU 0 for the calling (e.g. audio) thread. Pinning is
+   // only supported on Linux, and is a no-op elsewhere.
+   ////////////////////////////////////////////////////////////////////////////
+   class worker_pool : non_copyable
+   {
+   public:
+                              worker_pool(std::size_t num_workers, bool pin = false);
+                              ~worker_pool();
+
+      std::size_t             size() const { return _threads.size(); }
+
+      template <typename F>
+      void                    run(std::size_t n, F&& f);
+
+   private:
+
+      using task_function = void(*)(void*, std::size_t);
+
+      void                    work();
+      void                    drain();
+
+      std::vector<std::thread> _threads;
+      std::mutex              _mutex;
+      std::condition_variable _start;
+      std::condition_variable _done;
+      std::size_t             _generation = 0;
+      std::size_t             _active = 0;
+      bool                    _stop = false;
+
+      task_function           _task = nullptr;
+      void*                   _context = nullptr;
+      std::size_t             _size = 0;
+      std::atomic<std::size_t> _next{0};
+      std::atomic<std::size_t> _pending{0};
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   inline worker_pool::worker_pool(std::size_t num_workers, bool pin)
+   {
+      _threads.reserve(num_workers);
+      for (std::size_t i = 0; i != num_workers; ++i)
+      {
+         _threads.emplace_back([this]{ work(); });
+#if defined(__linux__)
+         if (pin)
+         {
+            auto num_cpus = std::max(1u, std::thread::hardware_concurrency());
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET((i + 1) % num_cpus, &cpus);
+            pthread_setaffinity_np(
+               _threads.back().native_handle(), sizeof(cpu_set_t), &cpus);
+         }
+#else
+         (void) pin;
+#endif
+      }
+   }
+
+   inline worker_pool::~worker_pool()
+   {
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         _stop = true;
+      }
+      _start.notify_all();
+      for (auto& t : _threads)
+         t.join();
+   }
+
+   template <typename F>
+   inline void worker_pool::run(std::size_t n, F&& f)
+   {
+      if (_threads.empty() || n < 2)
+      {
+         for (std::size_t i = 0; i != n; ++i)
+            f(i);
+         return;
+      }
+
+      using function_type = std::remove_reference_t<F>;
+      {
+         // Wait for stragglers from the previous run to leave drain()
+         // before the task is replaced.
+         std::unique_lock<std::mutex> lock(_mutex);
+         _done.wait(lock, [this]{ return _active == 0; });
+
+         _task = [](void* context, std::size_t i)
+         {
+            (*static_cast<function_type*>(context))(i);
+         };
+         _context = const_cast<void*>(static_cast<void const*>(&f));
+         _size = n;
+         _next = 0;
+         _pending = n;
+         ++_generation;
+      }
+      _start.notify_all();
+
+      // The calling thread works too
+      drain();
+
+      std::unique_lock<std::mutex> lock(_mutex);
+      _done.wait(lock, [this]{ return _pending == 0 && _active == 0; });
+   }
+
+   inline void worker_pool::drain()
+   {
+      for (auto i = _next++; i < _size; i = _next++)
+      {
+         _task(_context, i);
+         if (--_pending == 0)
+         {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done.notify_all();
+         }
+      }
+   }
+
+   inline void worker_pool::work()
+   {
+      std::size_t generation = 0;
+      for (;;)
+      {
+         {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _start.wait(lock, [&]{ return _stop || _generation != generation; });
+            if (_stop)
+               return;
+            generation = _generation;
+            ++_active;
+         }
+
+         drain();
+
+         {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_active == 0)
+               _done.notify_all();
+         }
+      }
+   }
+}
+
+#endif // Q_DONT_USE_THREADS
+#endif
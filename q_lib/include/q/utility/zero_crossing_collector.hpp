@@ -12,8 +12,11 @@
 #include <q/utility/ring_buffer.hpp>
 #include <q/support/decibel.hpp>
 #include <q/support/frequency.hpp>
+#include <q/detail/crossing_scan.hpp>
 #include <infra/assert.hpp>
+#include <array>
 #include <cmath>
+#include <vector>
 
 namespace cycfi::q
 {
@@ -37,14 +40,14 @@ namespace cycfi::q
    // Each call to the function operator, given a sample s, returns the
    // zero-crossing state (bool). is_ready() returns true when we have
    // sufficient info to perform analysis. is_ready() returns true after
-   // every window/2 frames. Information about each zero crossing can be
-   // obtained using the index operator[]. The leftmost edge (oldest) is at
-   // the 0th index while the rightmost edge (latest) is at index
-   // num_edges()-1.
+   // every hop (hop_size() frames, window/2 by default, see below).
+   // Information about each zero crossing can be obtained using the index
+   // operator[]. The leftmost edge (oldest) is at the 0th index while the
+   // rightmost edge (latest) is at index num_edges()-1.
    //
-   // After window/2 frames, the leading edge and trailing edge frame
-   // positions are shifted by -window/2 such that an edge at frame index N
-   // will be shifted to N-window/2. For example, if the window size is 100
+   // After each hop, the leading edge and trailing edge frame positions
+   // are shifted by -hop such that an edge at frame index N will be
+   // shifted to N-hop. For example, if the window size is 100 (hop 50)
    // and the leading edge is at frame 45, it will be shifted to -5 (45-50).
    //
    // This procedure is done to ensure seamless operation from one window to
@@ -54,15 +57,99 @@ namespace cycfi::q
    // latest edge to have a trailing edge that goes past the right side of
    // the window. If for example, with the same window size 100, there can be
    // an edge with a leading edge at 95 and trailing edge at 120.
+   //
+   // The overlap constructor parameter sets the hop: the window becomes
+   // ready overlap times per window length, every window/overlap frames.
+   // The default, 2, is a hop of half the window. Larger overlaps (4, 8 or
+   // 16) give more frequent analyses of the same window, for lower
+   // latency. Whatever the hop, peak_pulse() covers the same span: the
+   // current hop plus the previous half window.
+   //
+   // num_resets() counts the times the collector has discarded all its
+   // edges and started over. When two consecutive ready states have the
+   // same count, the edges of the latter are those of the former shifted by
+   // -hop, plus the new edges collected since. num_hops() counts the ready
+   // states, so a client can tell that it has not missed one. Clients can
+   // use these to update per-window data incrementally rather than rebuild
+   // it.
+   //
+   // The block function call operator, given n samples at in, processes
+   // samples until the zero-crossing state changes, the window becomes
+   // ready, the collector resets at the end of a window (is_reset()), or
+   // the samples run out, and returns the number of samples processed.
+   // The result is the same as calling the per-sample operator on each of
+   // them, but the runs of samples in between, which change nothing but
+   // the frame count and the peaks, are skipped with a vectorized scan.
+   //
+   // The Window policy decides where the window size comes from and how
+   // the edges (and the bitstream of clients like bacf_period_detector) are
+   // stored: dynamic_window (zero_crossing_collector) sizes them at run
+   // time in std::vectors, static_window<Window> fixes them at compile time
+   // in std::arrays (see below).
    ////////////////////////////////////////////////////////////////////////////
-   class zero_crossing_collector
+   namespace detail
+   {
+      constexpr std::size_t adjust_window_size(std::size_t window)
+      {
+         constexpr auto bits = bitset<>::value_size;
+         return std::max<std::size_t>(2, (window + bits - 1) / bits);
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Window storage policies.
+   //
+   // dynamic_window: the window size is given at construction time and
+   // storage is allocated from the heap.
+   //
+   // static_window<Window>: the window size, Window frames, is fixed at
+   // compile time and all storage is in std::arrays, with no dynamic
+   // allocation. The window given at construction time must round up to
+   // the same window_size. frames_storage holds the ready frames of a block
+   // (see bacf_period_detector::process), and keeps at most 16 of them.
+   ////////////////////////////////////////////////////////////////////////////
+   struct dynamic_window
+   {
+      template <typename T>
+      using edges_storage = std::vector<T>;
+      using bits_storage = std::vector<natural_uint>;
+      using frames_storage = std::vector<std::size_t>;
+
+      static constexpr std::size_t size(std::size_t window)
+      {
+         return detail::adjust_window_size(window) * bitset<>::value_size;
+      }
+   };
+
+   template <std::size_t Window>
+   struct static_window
+   {
+      static constexpr std::size_t window_size =
+         detail::adjust_window_size(Window) * bitset<>::value_size;
+
+      template <typename T>
+      using edges_storage = std::array<T, smallest_pow2(window_size / 2)>;
+      using bits_storage = std::array<natural_uint, window_size / bitset<>::value_size>;
+      using frames_storage = std::array<std::size_t, 16>;
+
+      static constexpr std::size_t size(std::size_t /* window */)
+      {
+         return window_size;
+      }
+   };
+
+   template <typename Window = dynamic_window>
+   class basic_zero_crossing_collector
    {
    public:
-      using self_type = zero_crossing_collector;
+      using self_type = basic_zero_crossing_collector;
+      using window_type = Window;
 
       static constexpr float pulse_height_diff = 0.8;
       static constexpr float pulse_width_diff = 0.85;
       static constexpr auto undefined_edge = int_min<int>();
+      static constexpr std::size_t default_overlap = 2;
+      static constexpr std::size_t max_overlap = 16;
 
       struct info
       {
@@ -81,22 +168,30 @@ namespace cycfi::q
          float             _width = 0.0f;
       };
 
-                           zero_crossing_collector(decibel hysteresis, duration window, float sps);
-                           zero_crossing_collector(decibel hysteresis, std::uint32_t window);
-                           zero_crossing_collector(zero_crossing_collector const& rhs) = default;
-                           zero_crossing_collector(zero_crossing_collector&& rhs) = default;
-      self_type&           operator=(zero_crossing_collector const& rhs) = default;
-      self_type&           operator=(zero_crossing_collector&& rhs) = default;
+                           basic_zero_crossing_collector(
+                              decibel hysteresis, duration window, float sps
+                            , std::size_t overlap = default_overlap);
+                           basic_zero_crossing_collector(
+                              decibel hysteresis, std::uint32_t window
+                            , std::size_t overlap = default_overlap);
+                           basic_zero_crossing_collector(basic_zero_crossing_collector const& rhs) = default;
+                           basic_zero_crossing_collector(basic_zero_crossing_collector&& rhs) = default;
+      self_type&           operator=(basic_zero_crossing_collector const& rhs) = default;
+      self_type&           operator=(basic_zero_crossing_collector&& rhs) = default;
 
       std::size_t          num_edges() const;
       std::size_t          capacity() const;
       std::size_t          frame() const;
       std::size_t          window_size() const;
+      std::size_t          hop_size() const;
       bool                 is_ready() const;
       float                peak_pulse() const;
       bool                 is_reset() const;
+      std::size_t          num_resets() const;
+      std::size_t          num_hops() const;
 
       bool                 operator()(float s);
+      std::size_t          operator()(float const* in, std::size_t n);
       bool                 operator()() const;
       info const&          operator[](std::size_t index) const;
       info&                operator[](std::size_t index);
@@ -104,10 +199,12 @@ namespace cycfi::q
    private:
 
       void                 update_state(float s);
+      std::size_t          skip(float const* in, std::size_t n);
       void                 shift(std::size_t n);
       void                 reset();
+      void                 update_peak();
 
-      using info_storage = ring_buffer<info>;
+      using info_storage = ring_buffer<info, typename Window::template edges_storage<info>>;
 
       float                _prev = 0.0f;
       float                _hysteresis;
@@ -119,51 +216,69 @@ namespace cycfi::q
       bool                 _ready = false;
       float                _peak_update = 0.0f;
       float                _peak = 0.0f;
+      std::size_t          _num_resets = 0;
+      std::size_t          _num_hops = 0;
+      std::size_t          _hop_size;
+
+      // The peaks of the last overlap/2 hops
+      using hop_peaks = std::array<float, max_overlap / 2>;
+
+      hop_peaks            _hop_peaks = {};
+      std::size_t          _num_hop_peaks;
+      std::size_t          _hop_index = 0;
    };
 
+   using zero_crossing_collector = basic_zero_crossing_collector<>;
+
    ////////////////////////////////////////////////////////////////////////////
    // Implementation
    ////////////////////////////////////////////////////////////////////////////
-   namespace detail
+   template <typename Window>
+   inline basic_zero_crossing_collector<Window>::basic_zero_crossing_collector(
+      decibel hysteresis, duration window, float sps, std::size_t overlap)
+    : basic_zero_crossing_collector{hysteresis, std::uint32_t(as_double(window) * sps), overlap}
    {
-      inline std::size_t adjust_window_size(std::size_t window)
-      {
-         constexpr auto bits = bitset<>::value_size;
-         return std::max<std::size_t>(2, (window + bits - 1) / bits);
-      }
    }
 
-   inline zero_crossing_collector::zero_crossing_collector(decibel hysteresis, duration window, float sps)
-    : zero_crossing_collector{hysteresis, std::uint32_t(as_double(window) * sps)}
+   template <typename Window>
+   inline basic_zero_crossing_collector<Window>::basic_zero_crossing_collector(
+      decibel hysteresis, std::uint32_t window, std::size_t overlap)
+    : _hysteresis(-lin_float(hysteresis))
+    , _window_size(Window::size(window))
+    , _info(detail::make_sized<info_storage>(_window_size / 2))
+    , _hop_size(_window_size / overlap)
+    , _num_hop_peaks(overlap / 2)
    {
+      CYCFI_ASSERT(_window_size == dynamic_window::size(window),
+         "The window does not match the storage.");
+      CYCFI_ASSERT(overlap >= 2 && overlap <= max_overlap && is_pow2(overlap),
+         "The overlap must be a power of 2, from 2 to max_overlap.");
    }
 
-   inline zero_crossing_collector::zero_crossing_collector(decibel hysteresis, std::uint32_t window)
-    : _hysteresis(-lin_float(hysteresis))
-    , _window_size(detail::adjust_window_size(window) * bitset<>::value_size)
-    , _info(_window_size / 2)
-   {}
-
-   inline void zero_crossing_collector::info::update_peak(float s, std::size_t frame)
+   template <typename Window>
+   inline void basic_zero_crossing_collector<Window>::info::update_peak(float s, std::size_t frame)
    {
       _peak = std::max(s, _peak);
       if ((_width == 0.0f) && (s < (_peak * 0.3)))
          _width = frame - _leading_edge;
    }
 
-   inline std::size_t zero_crossing_collector::info::period(info const& next) const
+   template <typename Window>
+   inline std::size_t basic_zero_crossing_collector<Window>::info::period(info const& next) const
    {
       CYCFI_ASSERT(_leading_edge <= next._leading_edge, "Invalid order.");
       return next._leading_edge - _leading_edge;
    }
 
-   inline bool zero_crossing_collector::info::similar(info const& next) const
+   template <typename Window>
+   inline bool basic_zero_crossing_collector<Window>::info::similar(info const& next) const
    {
       return rel_within(_peak, next._peak, 1.0f-pulse_height_diff) &&
          rel_within(_width, next._width, 1.0f-pulse_width_diff);
    }
 
-   inline float zero_crossing_collector::info::fractional_period(info const& next) const
+   template <typename Window>
+   inline float basic_zero_crossing_collector<Window>::info::fractional_period(info const& next) const
    {
       CYCFI_ASSERT(_leading_edge <= next._leading_edge, "Invalid order.");
 
@@ -184,56 +299,83 @@ namespace cycfi::q
       return result + (dx2 - dx1);
    }
 
-   inline std::size_t zero_crossing_collector::num_edges() const
+   template <typename Window>
+   inline std::size_t basic_zero_crossing_collector<Window>::num_edges() const
    {
       return _num_edges;
    }
 
-   inline std::size_t zero_crossing_collector::capacity() const
+   template <typename Window>
+   inline std::size_t basic_zero_crossing_collector<Window>::capacity() const
    {
       return _info.size();
    }
 
-   inline std::size_t zero_crossing_collector::frame() const
+   template <typename Window>
+   inline std::size_t basic_zero_crossing_collector<Window>::frame() const
    {
       return _frame;
    }
 
-   inline std::size_t zero_crossing_collector::window_size() const
+   template <typename Window>
+   inline std::size_t basic_zero_crossing_collector<Window>::window_size() const
    {
       return _window_size;
    }
 
-   inline void zero_crossing_collector::reset()
+   template <typename Window>
+   inline std::size_t basic_zero_crossing_collector<Window>::hop_size() const
+   {
+      return _hop_size;
+   }
+
+   template <typename Window>
+   inline void basic_zero_crossing_collector<Window>::reset()
    {
       _num_edges = 0;
       _state = false;
       _frame = 0;
+      ++_num_resets;
    }
 
-   inline bool zero_crossing_collector::is_reset() const
+   template <typename Window>
+   inline bool basic_zero_crossing_collector<Window>::is_reset() const
    {
       return _frame == 0;
    }
 
-   inline bool zero_crossing_collector::is_ready() const
+   template <typename Window>
+   inline std::size_t basic_zero_crossing_collector<Window>::num_resets() const
+   {
+      return _num_resets;
+   }
+
+   template <typename Window>
+   inline std::size_t basic_zero_crossing_collector<Window>::num_hops() const
+   {
+      return _num_hops;
+   }
+
+   template <typename Window>
+   inline bool basic_zero_crossing_collector<Window>::is_ready() const
    {
       return _ready;
    }
 
-   inline float zero_crossing_collector::peak_pulse() const
+   template <typename Window>
+   inline float basic_zero_crossing_collector<Window>::peak_pulse() const
    {
       return std::max(_peak, _peak_update);
    }
 
-   inline void zero_crossing_collector::update_state(float s)
+   template <typename Window>
+   inline void basic_zero_crossing_collector<Window>::update_state(float s)
    {
       if (_ready)
       {
-         shift(_window_size / 2);
+         shift(_hop_size);
          _ready = false;
-         _peak = _peak_update;
-         _peak_update = 0.0f;
+         update_peak();
       }
 
       if (num_edges() >= capacity())
@@ -269,7 +411,20 @@ namespace cycfi::q
       _prev = s;
    }
 
-   inline bool zero_crossing_collector::operator()(float s)
+   template <typename Window>
+   inline void basic_zero_crossing_collector<Window>::update_peak()
+   {
+      // _peak is the highest of the last overlap/2 hops, which is simply
+      // the previous hop with the default overlap of 2.
+      _hop_peaks[_hop_index] = _peak_update;
+      if (++_hop_index == _num_hop_peaks)
+         _hop_index = 0;
+      _peak = *std::max_element(_hop_peaks.begin(), _hop_peaks.begin() + _num_hop_peaks);
+      _peak_update = 0.0f;
+   }
+
+   template <typename Window>
+   inline bool basic_zero_crossing_collector<Window>::operator()(float s)
    {
       // Offset s by half of hysteresis, so that zero cross detection is
       // centered on the actual zero.
@@ -285,12 +440,15 @@ namespace cycfi::q
 
       if (++_frame >= _window_size && !_state)
       {
-         // Remove half the size from _frame, so we can continue seamlessly
-         _frame -= _window_size / 2;
+         // Remove the hop from _frame, so we can continue seamlessly
+         _frame -= _hop_size;
 
          // We need at least two rising edges.
          if (num_edges() > 1)
+         {
             _ready = true;
+            ++_num_hops;
+         }
          else
             reset();
       }
@@ -298,24 +456,83 @@ namespace cycfi::q
       return _state;
    };
 
-   inline bool zero_crossing_collector::operator()() const
+   template <typename Window>
+   inline std::size_t basic_zero_crossing_collector<Window>::skip(float const* in, std::size_t n)
+   {
+      // Skip the leading samples that the per-sample operator would only
+      // count (frame) and track (peaks and _prev). Anything that changes
+      // the state, or may, is left for the per-sample operator.
+      if (_ready || num_edges() >= capacity())
+         return 0;
+
+      auto const offset = _hysteresis / 2;
+      std::size_t k = 0;
+      if (!_state)
+      {
+         // Stop short of the frames where the window may end or reset
+         auto half = _window_size / 2;
+         std::size_t limit = (_frame + 1 < _window_size)? _window_size - 1 - _frame : 0;
+         if (num_edges() == 0 && _frame <= half)
+            limit = std::min(limit, half - _frame);
+         k = detail::scan_low(in, std::min(n, limit), offset);
+      }
+      else
+      {
+         auto& info = _info[0];
+         auto peak = info._peak;
+         k = detail::scan_high(in, n, offset, _hysteresis, info._width == 0.0f, peak);
+         info._peak = peak;
+         _peak_update = std::max(_peak_update, peak);
+      }
+
+      if (k)
+      {
+         _prev = in[k-1] + offset;
+         _frame += k;
+      }
+      return k;
+   }
+
+   template <typename Window>
+   inline std::size_t basic_zero_crossing_collector<Window>::operator()(float const* in, std::size_t n)
+   {
+      std::size_t i = 0;
+      while (i != n)
+      {
+         i += skip(in + i, n - i);
+         if (i == n)
+            break;
+
+         bool prev = _state;
+         (*this)(in[i++]);
+         if (_state != prev || _ready || is_reset())
+            break;
+      }
+      return i;
+   }
+
+   template <typename Window>
+   inline bool basic_zero_crossing_collector<Window>::operator()() const
    {
       return _state;
    }
 
-   inline zero_crossing_collector::info const&
-   zero_crossing_collector::operator[](std::size_t index) const
+   template <typename Window>
+   inline typename basic_zero_crossing_collector<Window>::info const&
+   basic_zero_crossing_collector<Window>::operator[](std::size_t index) const
    {
       return _info[(_num_edges-1)-index];
    }
 
-   inline zero_crossing_collector::info&
-   zero_crossing_collector::operator[](std::size_t index)
+   template <typename Window>
+   inline typename basic_zero_crossing_collector<Window>::info&
+   basic_zero_crossing_collector<Window>::operator[](std::size_t index)
    {
       return _info[(_num_edges-1)-index];
    }
 
-   inline void zero_crossing_collector::shift(std::size_t n)
+   template <typename Window>
+   inline void basic_zero_crossing_collector<Window>::shift(std::size_t n)
    {
       _info[0]._leading_edge -= n;
       if (!_state)
@@ -0,0 +1,116 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/fft/batch_fft.hpp>
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace q = cycfi::q;
+
+namespace
+{
+   // A different complex signal per channel
+   std::vector<float> make_channel(std::size_t n, std::size_t c)
+   {
+      std::vector<float> d(2*n);
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         d[2*i]   = std::sin(0.3 * i * (c + 1)) + 0.5 * std::cos(0.11 * i * i + c);
+         d[2*i+1] = 0.25 * std::sin(0.7 * i + c);
+      }
+      return d;
+   }
+
+   // The batch layout of K channels, in fft's layout
+   template <std::size_t K>
+   std::vector<float> transpose(std::array<std::vector<float>, K> const& ch, std::size_t n)
+   {
+      std::vector<float> d(2*K*n);
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         for (std::size_t c = 0; c != K; ++c)
+         {
+            d[2*K*i + c] = ch[c][2*i];
+            d[2*K*i + K + c] = ch[c][2*i+1];
+         }
+      }
+      return d;
+   }
+}
+
+TEMPLATE_TEST_CASE_SIG("batch_fft matches fft per channel", "[batch_fft]",
+   ((std::size_t N, std::size_t K), N, K),
+   (2, 4), (16, 1), (32, 3), (64, 4), (512, 4), (1024, 8), (2048, 6), (4096, 16))
+{
+   std::array<std::vector<float>, K> ch;
+   for (std::size_t c = 0; c != K; ++c)
+      ch[c] = make_channel(N, c);
+
+   auto d = transpose<K>(ch, N);
+   auto orig = d;
+   q::batch_fft<N, K>(d.data());
+
+   for (auto& x : ch)
+      q::fft<N>(x.data());
+   auto ref = transpose<K>(ch, N);
+
+   // Same engine, same tables: the same operations per channel, give or
+   // take the compiler's contraction of multiply-adds.
+   for (std::size_t i = 0; i != d.size(); ++i)
+      REQUIRE_THAT(d[i], Catch::Matchers::WithinAbs(ref[i], 1e-6 * N));
+
+   q::batch_ifft<N, K>(d.data());
+   for (std::size_t i = 0; i != d.size(); ++i)
+      REQUIRE_THAT(d[i], Catch::Matchers::WithinAbs(orig[i], 1e-4));
+}
+
+TEST_CASE("batch_interleave and batch_deinterleave", "[batch_fft]")
+{
+   constexpr std::size_t N = 256;
+   constexpr std::size_t K = 4;
+
+   // A sine per channel, at bins 1, 2, 3 and 4
+   std::array<std::vector<float>, K> ch;
+   std::array<float const*, K> in;
+   for (std::size_t c = 0; c != K; ++c)
+   {
+      ch[c].resize(N);
+      for (std::size_t i = 0; i != N; ++i)
+         ch[c][i] = std::cos(2 * q::pi * (c + 1) * i / N);
+      in[c] = ch[c].data();
+   }
+
+   std::vector<float> d(2*K*N);
+   q::batch_interleave<K>(in.data(), N, d.data());
+   q::batch_fft<N, K>(d.data());
+
+   // A real cosine of bin k reads N/2 at bins k and N-k
+   for (std::size_t c = 0; c != K; ++c)
+   {
+      auto k = c + 1;
+      CHECK(d[2*K*k + c] == Approx(N / 2.0).epsilon(1e-5));
+      CHECK(d[2*K*(N-k) + c] == Approx(N / 2.0).epsilon(1e-5));
+      CHECK(std::abs(d[2*K*(k+1) + c]) < 1e-3);
+   }
+
+   q::batch_ifft<N, K>(d.data());
+   std::array<std::vector<float>, K> out;
+   std::array<float*, K> outp;
+   for (std::size_t c = 0; c != K; ++c)
+   {
+      out[c].resize(N);
+      outp[c] = out[c].data();
+   }
+   q::batch_deinterleave<K>(d.data(), N, outp.data());
+   for (std::size_t c = 0; c != K; ++c)
+      for (std::size_t i = 0; i != N; ++i)
+         REQUIRE(out[c][i] == Approx(ch[c][i]).margin(1e-5));
+}
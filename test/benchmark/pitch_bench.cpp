@@ -0,0 +1,286 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+
+   Throughput and accuracy benchmark for the pitch detection pipeline:
+   every file in audio_files is replayed through signal_conditioner and
+   pitch_detector, a block at a time, as an audio callback would. Reported
+   per file, and in total, as JSON on stdout:
+
+      ns_per_sample           conditioner plus detector
+      conditioner_ns, detector_ns
+                              the same, per stage
+      frames_per_sec          input frames processed per second of CPU
+                              time (divide by the sample rate for the
+                              real-time factor)
+      analyses                the number of BACF analyses
+      worst_analysis_ns       the most expensive single analysis, the
+                              figure that bounds the worst-case block
+      golden                  the estimates against golden/frequencies,
+                              in cents (where a golden file exists)
+
+   Build-only; not a CI test (nothing to assert, just measure and print).
+   Run it from the test build directory, where audio_files and golden are
+   copied, or pass that directory as the first argument.
+=============================================================================*/
+#include <q/support/literals.hpp>
+#include <q/pitch/pitch_detector.hpp>
+#include <q/fx/signal_conditioner.hpp>
+#include <q_io/audio_file.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../pitch.hpp"
+
+namespace q = cycfi::q;
+namespace fs = std::filesystem;
+using namespace q::literals;
+using namespace notes;
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::size_t block_size = 64;
+constexpr auto hysteresis = -40_dB;
+
+// The lowest note of each file, for the detection range. The range is
+// lowest * 0.8 to lowest * 5, as in pitch_detector_ex. Files not listed
+// here get the guitar's range.
+std::map<std::string, q::frequency> const lowest_notes =
+{
+   { "-1a-Low-B", low_b }, { "-1b-Low-B-12th", low_b }, { "-1c-Low-B-24th", low_b },
+   { "-2a-F#", low_fs }, { "-2b-F#-12th", low_fs }, { "-2c-F#-24th", low_fs },
+   { "1a-Low-E", low_e }, { "1b-Low-E-12th", low_e }, { "1c-Low-E-24th", low_e },
+   { "2a-A", a }, { "2b-A-12th", a }, { "2c-A-24th", a },
+   { "3a-D", d }, { "3b-D-12th", d }, { "3c-D-24th", d },
+   { "4a-G", g }, { "4b-G-12th", g }, { "4c-G-24th", g },
+   { "5a-B", b }, { "5b-B-12th", b }, { "5c-B-24th", b },
+   { "6a-High-E", high_e }, { "6b-High-E-12th", high_e }, { "6c-High-E-24th", high_e },
+   { "sin_440", d }, { "Tapping D", d }, { "harmonic D", d },
+   { "Hammer-Pull High E", high_e },
+   { "Slide G", g }, { "Bend-Slide G", g }, { "harmonic G", g },
+   { "GLines1", g }, { "GLines3", g }, { "SingleStaccato", g },
+   { "GStaccato", g }, { "ShortStaccato", g }, { "Attack-Reset", g },
+   { "harmonics_261", middle_c }, { "harmonics_329", low_e_24th },
+   { "harmonics_1318", high_e_24th },
+};
+
+struct estimate
+{
+   float time;
+   float frequency;
+};
+
+struct result
+{
+   std::string       name;
+   float             sps = 0;
+   std::size_t       samples = 0;
+   double            conditioner_ns = 0;
+   double            detector_ns = 0;
+   std::size_t       analyses = 0;
+   double            worst_analysis_ns = 0;
+
+   bool              has_golden = false;
+   std::size_t       golden_frames = 0;   // golden frames with a pitch
+   std::size_t       matched = 0;         // ... where we have one too
+   double            mean_abs_cents = 0;
+   double            max_abs_cents = 0;
+   std::size_t       within_10_cents = 0;
+};
+
+double elapsed_ns(clock_type::time_point start)
+{
+   return std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+}
+
+// Each golden row is "frequency, periodicity, time". Compare against our
+// latest estimate at that time.
+void compare_golden(fs::path const& path, std::vector<estimate> const& ours, result& r)
+{
+   std::ifstream csv(path);
+   if (!csv)
+      return;
+   r.has_golden = true;
+
+   std::size_t pos = 0;
+   double sum = 0;
+   std::string line;
+   while (std::getline(csv, line))
+   {
+      std::replace(line.begin(), line.end(), ',', ' ');
+      std::istringstream row(line);
+      float f, p, time;
+      if (!(row >> f >> p >> time) || f <= 0.0f)
+         continue;
+      ++r.golden_frames;
+
+      while (pos != ours.size() && ours[pos].time <= time)
+         ++pos;
+      if (pos == 0 || ours[pos-1].frequency <= 0.0f)
+         continue;
+
+      auto cents = std::abs(1200.0 * std::log2(ours[pos-1].frequency / f));
+      ++r.matched;
+      sum += cents;
+      r.max_abs_cents = std::max(r.max_abs_cents, cents);
+      if (cents <= 10.0)
+         ++r.within_10_cents;
+   }
+   if (r.matched)
+      r.mean_abs_cents = sum / r.matched;
+}
+
+result run(fs::path const& root, std::string const& name)
+{
+   result r;
+   r.name = name;
+
+   q::wav_reader src{ (root / "audio_files" / (name + ".wav")).string() };
+   r.sps = src.sps();
+   std::vector<float> in(src.length());
+   src.read(in);
+   r.samples = in.size();
+
+   auto i = lowest_notes.find(name);
+   auto lowest = (i != lowest_notes.end())? i->second : low_e;
+   auto highest = lowest * 5;
+   lowest = lowest * 0.8;
+
+   auto sc_conf = q::signal_conditioner::config{};
+   q::signal_conditioner sig_cond{ sc_conf, lowest, highest, r.sps };
+   q::pitch_detector pd{ lowest, highest, r.sps, hysteresis };
+
+   std::vector<estimate> ours;
+   std::vector<float> block(block_size);
+   for (std::size_t pos = 0; pos < in.size(); pos += block_size)
+   {
+      auto n = std::min(block_size, in.size() - pos);
+
+      auto start = clock_type::now();
+      for (std::size_t j = 0; j != n; ++j)
+         block[j] = sig_cond(in[pos + j]);
+      r.conditioner_ns += elapsed_ns(start);
+
+      // The scan and the analyses are timed apart, to single out the
+      // cost of each analysis.
+      for (std::size_t j = 0; j != n;)
+      {
+         start = clock_type::now();
+         j += pd.collect(block.data() + j, n - j);
+         r.detector_ns += elapsed_ns(start);
+
+         if (pd.get_period_detector().is_ready())
+         {
+            start = clock_type::now();
+            pd.analyze();
+            auto ns = elapsed_ns(start);
+            r.detector_ns += ns;
+            r.worst_analysis_ns = std::max(r.worst_analysis_ns, ns);
+            ++r.analyses;
+            ours.push_back({ (pos + j - 1) / r.sps, pd.get_frequency() });
+         }
+      }
+   }
+
+   compare_golden(root / "golden" / "frequencies" / (name + ".csv"), ours, r);
+   return r;
+}
+
+void print(std::ostream& out, result const& r)
+{
+   auto total_ns = r.conditioner_ns + r.detector_ns;
+   out
+      << "    {\n"
+      << "      \"name\": \"" << r.name << "\",\n"
+      ;
+   if (r.sps != 0)
+      out << "      \"sps\": " << r.sps << ",\n";
+   out
+      << "      \"samples\": " << r.samples << ",\n"
+      << "      \"ns_per_sample\": " << total_ns / r.samples << ",\n"
+      << "      \"conditioner_ns\": " << r.conditioner_ns / r.samples << ",\n"
+      << "      \"detector_ns\": " << r.detector_ns / r.samples << ",\n"
+      << "      \"frames_per_sec\": " << r.samples / (total_ns * 1e-9) << ",\n"
+      << "      \"analyses\": " << r.analyses << ",\n"
+      << "      \"worst_analysis_ns\": " << r.worst_analysis_ns << ",\n"
+      << "      \"golden\": "
+      ;
+
+   if (r.has_golden)
+   {
+      out
+         << "{ \"frames\": " << r.golden_frames
+         << ", \"matched\": " << r.matched
+         << ", \"mean_abs_cents\": " << r.mean_abs_cents
+         << ", \"max_abs_cents\": " << r.max_abs_cents
+         << ", \"within_10_cents\": " << r.within_10_cents
+         << " }\n";
+   }
+   else
+   {
+      out << "null\n";
+   }
+   out << "    }";
+}
+
+int main(int argc, char const* argv[])
+{
+   fs::path root = (argc > 1)? argv[1] : ".";
+
+   std::vector<std::string> names;
+   for (auto const& entry : fs::directory_iterator(root / "audio_files"))
+   {
+      if (entry.path().extension() == ".wav")
+         names.push_back(entry.path().stem().string());
+   }
+   std::sort(names.begin(), names.end());
+
+   if (names.empty())
+   {
+      std::cerr << "No audio files found in " << (root / "audio_files") << '\n';
+      return 1;
+   }
+
+   result total;
+   std::size_t golden_matched = 0;
+   double golden_sum = 0;
+
+   std::cout << "{\n  \"block_size\": " << block_size << ",\n  \"files\": [\n";
+   for (std::size_t i = 0; i != names.size(); ++i)
+   {
+      auto r = run(root, names[i]);
+      print(std::cout, r);
+      std::cout << ((i + 1 != names.size())? ",\n" : "\n");
+
+      total.samples += r.samples;
+      total.conditioner_ns += r.conditioner_ns;
+      total.detector_ns += r.detector_ns;
+      total.analyses += r.analyses;
+      total.worst_analysis_ns = std::max(total.worst_analysis_ns, r.worst_analysis_ns);
+      total.golden_frames += r.golden_frames;
+      total.within_10_cents += r.within_10_cents;
+      total.max_abs_cents = std::max(total.max_abs_cents, r.max_abs_cents);
+      golden_matched += r.matched;
+      golden_sum += r.mean_abs_cents * r.matched;
+   }
+
+   total.name = "total";
+   total.has_golden = golden_matched != 0;
+   total.matched = golden_matched;
+   total.mean_abs_cents = golden_matched? golden_sum / golden_matched : 0;
+
+   std::cout << "  ],\n  \"total\":\n";
+   print(std::cout, total);
+   std::cout << "\n}\n";
+   return 0;
+}
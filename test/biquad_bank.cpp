@@ -0,0 +1,147 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/fx/biquad_bank.hpp>
+#include <q/support/literals.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace q = cycfi::q;
+using namespace q::literals;
+using Catch::Matchers::WithinAbs;
+
+namespace
+{
+   constexpr float sps = 48000;
+
+   // A different filter for each channel
+   q::biquad make_filter(std::size_t ch)
+   {
+      auto f = q::frequency(100.0 + 700.0 * ch);
+      switch (ch % 4)
+      {
+         case 0: return q::lowpass{ f, sps };
+         case 1: return q::highpass{ f, sps, 1.5 };
+         case 2: return q::peaking{ 6.0, f, sps, 0.7 };
+         default: return q::notch{ f, sps };
+      }
+   }
+
+   struct channels
+   {
+      channels(std::size_t n_channels, std::size_t n_frames)
+       : data(n_channels, std::vector<float>(n_frames))
+      {
+         for (auto& d : data)
+            ptrs.push_back(d.data());
+      }
+
+      std::vector<std::vector<float>> data;
+      std::vector<float*> ptrs;
+   };
+
+   // Filter n_frames in blocks of the given size with a bank and with a
+   // biquad per channel, and compare
+   template <std::size_t N>
+   void check_bank(std::size_t n_frames, std::size_t block, bool in_place)
+   {
+      channels in(N, n_frames), out(N, n_frames);
+      for (std::size_t c = 0; c != N; ++c)
+         for (std::size_t i = 0; i != n_frames; ++i)
+            in.data[c][i] = std::sin(0.013 * (c + 1) * i) + 0.3 * std::sin(0.71 * i);
+
+      q::biquad_bank<N> bank;
+      std::vector<q::biquad> filters;
+      for (std::size_t c = 0; c != N; ++c)
+      {
+         filters.push_back(make_filter(c));
+         bank.config(c, filters.back());
+      }
+
+      auto& dst = in_place? in : out;
+      auto ref = in.data;
+      for (std::size_t i = 0; i < n_frames; i += block)
+      {
+         auto n = std::min(block, n_frames - i);
+         std::vector<float const*> src(N);
+         std::vector<float*> to(N);
+         for (std::size_t c = 0; c != N; ++c)
+         {
+            src[c] = in.ptrs[c] + i;
+            to[c] = dst.ptrs[c] + i;
+         }
+         bank.process(
+            q::multi_buffer<float const>{ src.data(), N, n }
+          , q::multi_buffer<float>{ to.data(), N, n }
+         );
+      }
+
+      for (std::size_t c = 0; c != N; ++c)
+         for (std::size_t i = 0; i != n_frames; ++i)
+            REQUIRE_THAT(dst.data[c][i], WithinAbs(filters[c](ref[c][i]), 1e-4));
+   }
+}
+
+TEST_CASE("biquad_bank: matches a biquad per channel")
+{
+   check_bank<1>(1000, 1000, false);
+   check_bank<4>(1000, 1000, false);
+   check_bank<6>(1000, 1000, false);
+   check_bank<8>(1000, 1000, false);
+   check_bank<13>(1000, 1000, false);
+   check_bank<32>(1000, 1000, false);
+}
+
+TEST_CASE("biquad_bank: blocks and in place")
+{
+   check_bank<8>(1000, 7, false);
+   check_bank<12>(1001, 64, true);
+   check_bank<5>(999, 3, true);
+}
+
+TEST_CASE("biquad_bank: config keeps the state")
+{
+   constexpr std::size_t n = 512;
+   channels in(4, n), out(4, n);
+   for (std::size_t i = 0; i != n; ++i)
+      for (std::size_t c = 0; c != 4; ++c)
+         in.data[c][i] = std::sin(0.05 * i);
+
+   q::biquad_bank<4> bank;
+   auto lp = q::lowpass{ 1_kHz, sps };
+   for (std::size_t c = 0; c != 4; ++c)
+      bank.config(c, lp);
+
+   // The second half with a new cutoff on channel 2
+   std::vector<float const*> src(4);
+   std::vector<float*> dst(4);
+   for (std::size_t half = 0; half != 2; ++half)
+   {
+      if (half == 1)
+         bank.config(2, q::lowpass{ 3_kHz, sps });
+      for (std::size_t c = 0; c != 4; ++c)
+      {
+         src[c] = in.ptrs[c] + half * n/2;
+         dst[c] = out.ptrs[c] + half * n/2;
+      }
+      bank.process(
+         q::multi_buffer<float const>{ src.data(), 4, n/2 }
+       , q::multi_buffer<float>{ dst.data(), 4, n/2 }
+      );
+   }
+
+   auto ref = lp;
+   for (std::size_t i = 0; i != n; ++i)
+   {
+      if (i == n/2)
+         ref.config(3_kHz, sps);
+      REQUIRE_THAT(out.data[2][i], WithinAbs(ref(in.data[2][i]), 1e-4));
+   }
+}
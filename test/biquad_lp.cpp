@@ -10,6 +10,7 @@
 #include <q/fx/biquad.hpp>
 #include <q_io/audio_file.hpp>
 #include <vector>
+#include <algorithm>
 #include <string>
 #include "pitch.hpp"
 #include "golden_csv.hpp"
@@ -18,7 +19,7 @@
 namespace q = cycfi::q;
 using namespace q::literals;
 
-void process(std::string name, q::frequency base_freq)
+void process(std::string name, q::frequency base_freq, bool block = false)
 {
    ////////////////////////////////////////////////////////////////////////////
    // Read audio file
@@ -37,30 +38,64 @@ void process(std::string name, q::frequency base_freq)
    auto lp2 = q::lowpass{ base_freq * 2, sps, 0.70710678 };
    auto lp3 = q::lowpass{ base_freq * 2, sps, 1.9318517 };
 
-   for (auto i = 0; i != in.size(); ++i)
+   if (block)
    {
-      auto pos = i * n_channels;
-      auto ch1 = pos;
-      auto ch2 = pos+1;
-      auto ch3 = pos+2;
-      auto ch4 = pos+3;
-
-      auto s = in[i];
-
-      // Original signal
-      out[ch1] = s;
-
-      // Low pass filter 1
-      s = lp1(s);
-      out[ch2] = s * 3;
-
-      // Low pass filter 2
-      s = lp2(s);
-      out[ch3] = s * 3;
+      // The same cascade, with biquad::process, a block at a time
+      constexpr std::size_t block_size = 256;
+      std::vector<float> s1(in.size()), s2(in.size()), s3(in.size());
+      for (std::size_t i = 0; i < in.size(); i += block_size)
+      {
+         auto n = std::min(block_size, in.size() - i);
+         lp1.process(in.data() + i, s1.data() + i, n);
+         lp2.process(s1.data() + i, s2.data() + i, n);
+         lp3.process(s2.data() + i, s3.data() + i, n);
+      }
+
+      for (auto i = 0; i != in.size(); ++i)
+      {
+         auto pos = i * n_channels;
+         out[pos] = in[i];
+         out[pos+1] = s1[i] * 3;
+         out[pos+2] = s2[i] * 3;
+         out[pos+3] = s3[i] * 4;
+      }
+   }
+   else
+   {
+      for (auto i = 0; i != in.size(); ++i)
+      {
+         auto pos = i * n_channels;
+         auto ch1 = pos;
+         auto ch2 = pos+1;
+         auto ch3 = pos+2;
+         auto ch4 = pos+3;
+
+         auto s = in[i];
+
+         // Original signal
+         out[ch1] = s;
+
+         // Low pass filter 1
+         s = lp1(s);
+         out[ch2] = s * 3;
+
+         // Low pass filter 2
+         s = lp2(s);
+         out[ch3] = s * 3;
+
+         // Low pass filter 3
+         s = lp3(s);
+         out[ch4] = s * 4;
+      }
+   }
 
-      // Low pass filter 3
-      s = lp3(s);
-      out[ch4] = s * 4;
+   if (block)
+   {
+      // Must match the goldens of the per-sample filters
+      auto g_rows = q_test::windowed_level_csv(out, n_channels, sps);
+      auto g_cols = q_test::level_columns(n_channels);
+      q_test::compare_golden_csv("biquad_lp/" + name, g_cols, g_rows);
+      return;
    }
 
    ////////////////////////////////////////////////////////////////////////////
@@ -107,4 +142,32 @@ TEST_CASE("biquad_lp: audio files")
    process("GLines2", g);
    process("GLines3", g);
    process("GStaccato", g);
-}
\ No newline at end of file
+}
+
+TEST_CASE("biquad_lp: block processing")
+{
+   using namespace notes;
+
+   process("-2a-F#", low_fs, true);
+   process("-1a-Low-B", low_b, true);
+   process("1a-Low-E", low_e, true);
+   process("1b-Low-E-12th", low_e, true);
+   process("2a-A", a, true);
+   process("2b-A-12th", a, true);
+   process("3a-D", d, true);
+   process("3b-D-12th", d, true);
+   process("4a-G", g, true);
+   process("4b-G-12th", g, true);
+   process("5a-B", b, true);
+   process("5b-B-12th", b, true);
+   process("6a-High-E", high_e, true);
+   process("6b-High-E-12th", high_e, true);
+
+   process("Tapping D", d, true);
+   process("Hammer-Pull High E", high_e, true);
+   process("Bend-Slide G", g, true);
+   process("GLines1", g, true);
+   process("GLines2", g, true);
+   process("GLines3", g, true);
+   process("GStaccato", g, true);
+}
@@ -8,6 +8,7 @@
 #include <infra/catch.hpp>
 #include <q/support/literals.hpp>
 #include <q/utility/bitset.hpp>
+#include <array>
 
 namespace q = cycfi::q;
 
@@ -99,4 +100,61 @@ TEST_CASE("Test_bitset_64")
    CHECK(bs.get(1));
    CHECK(bs.get(126));
    CHECK(!bs.get(127));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test_bitset_slide")
+{
+   q::bitset<std::uint64_t> bs{ 256 };
+
+   // Unaligned slide: bits straddle word boundaries
+   bs.set(100, 60, true);
+   bs.slide(40);
+   CHECK(!bs.get(59));
+   CHECK(bs.get(60));
+   CHECK(bs.get(119));
+   CHECK(!bs.get(120));
+   CHECK(bs.data()[0] == 0xF000000000000000);
+   CHECK(bs.data()[1] == 0x00FFFFFFFFFFFFFF);
+   CHECK(bs.data()[2] == 0x0000000000000000);
+   CHECK(bs.data()[3] == 0x0000000000000000);
+
+   // Word aligned slide
+   bs.slide(64);
+   CHECK(bs.data()[0] == 0x00FFFFFFFFFFFFFF);
+   CHECK(bs.data()[1] == 0x0000000000000000);
+
+   // The vacated bits at the end are cleared
+   bs.set(0, 256, true);
+   bs.slide(96);
+   CHECK(bs.get(159));
+   CHECK(!bs.get(160));
+   CHECK(bs.data()[2] == 0x00000000FFFFFFFF);
+   CHECK(bs.data()[3] == 0x0000000000000000);
+
+   // Sliding by the full size clears everything
+   bs.slide(256);
+   for (auto i = 0; i != 4; ++i)
+      CHECK(bs.data()[i] == 0);
+}
+
+TEST_CASE("Test_bitset_fixed_storage")
+{
+   // A bitset with std::array storage: no allocation, same behavior
+   q::bitset<std::uint64_t, std::array<std::uint64_t, 4>> bs;
+   q::bitset<std::uint64_t> ref{ 256 };
+
+   CHECK(bs.size() == 256);
+   for (auto i = 0; i != 4; ++i)
+      CHECK(bs.data()[i] == 0);
+
+   bs.set(100, 60, true);
+   ref.set(100, 60, true);
+   bs.set(3, true);
+   ref.set(3, true);
+   bs.slide(40);
+   ref.slide(40);
+   for (auto i = 0; i != 4; ++i)
+      CHECK(bs.data()[i] == ref.data()[i]);
+   CHECK(bs.get(60));
+   CHECK(!bs.get(3));
+}
@@ -0,0 +1,117 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+#include <q/utility/bitstream_acf.hpp>
+
+#include <random>
+#include <vector>
+
+namespace q = cycfi::q;
+
+namespace
+{
+   // The original one-lag-at-a-time loop, kept as the reference.
+   template <typename T>
+   std::size_t reference_acf(q::bitset<T> const& bits, std::size_t pos)
+   {
+      constexpr auto value_size = q::bitset<T>::value_size;
+      auto const mid_array = std::max<std::size_t>(
+         ((bits.size() / value_size) / 2) - 1, 1);
+      auto const index = pos / value_size;
+      auto const shift = pos % value_size;
+
+      auto const* p1 = bits.data();
+      auto const* p2 = bits.data() + index;
+      std::size_t count = 0;
+
+      for (std::size_t i = 0; i != mid_array; ++i)
+      {
+         auto v = *p2++ >> shift;
+         if (shift != 0)
+            v |= *p2 << (value_size - shift);
+         count += q::detail::count_bits(*p1++ ^ v);
+      }
+      return count;
+   }
+
+   // Random pulses, the way bacf_period_detector rasterizes edges.
+   template <typename T>
+   q::bitset<T> make_bits(std::size_t num_bits, unsigned seed)
+   {
+      q::bitset<T> bits{num_bits};
+      std::mt19937 gen{seed};
+      std::uniform_int_distribution<std::size_t> width{1, 40};
+      for (std::size_t i = 0; i < bits.size(); i += width(gen))
+      {
+         auto n = width(gen);
+         bits.set(i, n, true);
+         i += n;
+      }
+      return bits;
+   }
+
+   template <typename T>
+   void check_all_lags(std::size_t num_bits, unsigned seed)
+   {
+      auto bits = make_bits<T>(num_bits, seed);
+      q::bitstream_acf<T> ac{bits};
+      auto const mid = ac._mid_array * q::bitset<T>::value_size;
+
+      std::vector<std::size_t> counts(mid);
+      ac(0, mid, counts.data());
+
+      for (std::size_t pos = 0; pos != mid; ++pos)
+      {
+         INFO("num_bits: " << num_bits << " pos: " << pos);
+         auto expected = reference_acf(bits, pos);
+         REQUIRE(ac(pos) == expected);
+         REQUIRE(counts[pos] == expected);
+      }
+   }
+}
+
+TEST_CASE("bitstream_acf: single and multi-lag kernels match the reference")
+{
+   for (std::size_t num_bits : { 128, 320, 1000, 1920, 4096 })
+   {
+      check_all_lags<std::uint64_t>(num_bits, num_bits);
+      check_all_lags<std::uint32_t>(num_bits, num_bits + 1);
+   }
+}
+
+TEST_CASE("bitstream_acf: partial lag ranges")
+{
+   auto bits = make_bits<std::uint64_t>(2048, 7);
+   q::bitstream_acf<> ac{bits};
+
+   // Ranges that start and end mid-word, and ranges of 1 to 5 lags, so
+   // every group size of the vector kernel is exercised.
+   for (std::size_t first : { 1, 30, 63, 64, 65, 127, 500 })
+   {
+      for (std::size_t n : { 1, 2, 3, 4, 5, 70 })
+      {
+         std::vector<std::size_t> counts(n);
+         ac(first, first + n, counts.data());
+         for (std::size_t k = 0; k != n; ++k)
+            CHECK(counts[k] == reference_acf(bits, first + k));
+      }
+   }
+}
+
+TEST_CASE("bitstream_acf: a periodic bitstream correlates perfectly at its period")
+{
+   constexpr std::size_t period = 37;
+   q::bitset<> bits{2048};
+   for (std::size_t i = 0; i < bits.size(); i += period)
+      bits.set(i, 15, true);
+
+   q::bitstream_acf<> ac{bits};
+   CHECK(ac(period) == 0);
+   CHECK(ac(period * 3) == 0);
+   CHECK(ac(period + 1) != 0);
+}
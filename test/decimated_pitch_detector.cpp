@@ -0,0 +1,133 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/pitch/decimated_pitch_detector.hpp>
+#include <q/support/pitch_names.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace q = cycfi::q;
+using namespace q::literals;
+using namespace q::pitch_names;
+
+constexpr auto pi = q::pi;
+
+// The open strings of a 4-string bass
+q::frequency const bass_strings[] = { E[1], A[1], D[2], G[2] };
+
+std::vector<float> pluck(q::frequency freq, float sps, std::size_t size)
+{
+   // A decaying note with strong 2nd and 3rd harmonics
+   auto period = as_double(sps / freq);
+   std::vector<float> signal(size);
+   for (std::size_t i = 0; i != size; ++i)
+   {
+      auto env = std::exp(-double(i) / (sps * 0.5));
+      auto angle = 2 * pi * i / period;
+      signal[i] = env * (0.3 * std::sin(angle)
+         + 0.4 * std::sin(2 * angle + 0.3)
+         + 0.3 * std::sin(3 * angle + 0.6));
+   }
+   return signal;
+}
+
+TEST_CASE("Test_decimation_factor")
+{
+   using pd = q::decimated_pitch_detector;
+
+   // Bass range: the decimated rate must stay above 16 x highest_freq
+   CHECK(pd::decimation_factor(E[1], 400_Hz, 48000) == 4);
+   CHECK(pd::decimation_factor(E[1], 400_Hz, 96000) == 8);
+   CHECK(pd::decimation_factor(E[1], 100_Hz, 96000) == 16);
+
+   // Guitar range at 44.1 kHz: no room to decimate
+   CHECK(pd::decimation_factor(E[2], 1400_Hz, 44100) == 1);
+
+   // The window must stay at least 128 frames long
+   CHECK(pd::decimation_factor(1000_Hz, 1200_Hz, 96000) == 1);
+}
+
+TEST_CASE("Test_decimated_bass")
+{
+   for (float sps : { 48000.0f, 96000.0f })
+   {
+      for (auto freq : bass_strings)
+      {
+         INFO("sps: " << sps << " freq: " << as_float(freq));
+         auto in = pluck(freq, sps, sps);
+
+         q::decimated_pitch_detector dpd{ E[1] * 0.9, 400_Hz, sps, -45_dB };
+         q::pitch_detector pd{ E[1] * 0.9, 400_Hz, sps, -45_dB };
+         CHECK(dpd.decimation() > 1);
+
+         // The window and its buffers shrink by the decimation factor
+         auto const& edges = dpd.get_pitch_detector().edges();
+         CHECK(edges.window_size() * dpd.decimation() <= pd.edges().window_size() + 64 * dpd.decimation());
+
+         for (auto s : in)
+         {
+            dpd(s);
+            pd(s);
+         }
+         CHECK(dpd.get_frequency() == Approx(as_float(freq)).epsilon(0.002));
+         CHECK(dpd.get_frequency() == Approx(pd.get_frequency()).epsilon(0.002));
+      }
+   }
+}
+
+TEST_CASE("Test_decimated_block_process")
+{
+   // process(in, n) must give the same results as the per-sample call, at
+   // the same (input rate) frames.
+   float const sps = 48000;
+   auto in = pluck(A[1], sps, sps / 2);
+   auto d = pluck(D[2], sps, sps / 2);
+   in.insert(in.end(), d.begin(), d.end());
+
+   for (std::size_t block_size : { 1, 5, 64, 1000, 4096 })
+   {
+      INFO("block size: " << block_size);
+      q::decimated_pitch_detector dpd{ E[1], 400_Hz, sps, -45_dB };
+      q::decimated_pitch_detector ref{ E[1], 400_Hz, sps, -45_dB };
+      std::size_t num_ready = 0;
+
+      for (std::size_t pos = 0; pos < in.size(); pos += block_size)
+      {
+         auto n = std::min(block_size, in.size() - pos);
+         auto const* block = in.data() + pos;
+
+         std::vector<std::size_t> expected;
+         std::vector<float> expected_f;
+         for (std::size_t i = 0; i != n; ++i)
+         {
+            if (ref(block[i]))
+            {
+               expected.push_back(i);
+               expected_f.push_back(ref.get_frequency());
+            }
+         }
+
+         std::size_t k = 0;
+         auto frames = dpd.process(block, n,
+            [&](std::size_t frame)
+            {
+               REQUIRE(k < expected_f.size());
+               CHECK(dpd.get_frequency() == expected_f[k++]);
+            }
+         );
+         REQUIRE(frames.size() == expected.size());
+         CHECK(std::equal(frames.begin(), frames.end(), expected.begin()));
+         num_ready += expected.size();
+      }
+      CHECK(dpd.get_frequency() == Approx(as_float(D[2])).epsilon(0.002));
+      CHECK(num_ready > 10);
+   }
+}
@@ -8,6 +8,7 @@
 #include <infra/catch.hpp>
 #include <q/fx/fast_downsample.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <complex>
@@ -309,3 +310,58 @@ static_assert(constexpr_run<2>() == 1.0);
 static_assert(constexpr_run<3>() == 1.0);
 static_assert(constexpr_run<4>() == 1.0);
 static_assert(constexpr_run<5>() == 1.0);
+
+///////////////////////////////////////////////////////////////////////////////
+// basic_fast_downsample_cascade must agree exactly with chaining the stages
+// by hand, whether fed a sample at a time or in blocks of any size (odd
+// sizes leave a held sample pending in some stages), and zero stages must
+// pass the input through.
+///////////////////////////////////////////////////////////////////////////////
+TEST_CASE("Test_fast_downsample_cascade")
+{
+   using DS = q::basic_fast_downsample<5, double>;
+   auto x = pseudo_random<double>(1000);
+
+   for (std::size_t stages = 0; stages != 5; ++stages)
+   {
+      INFO("stages: " << stages);
+
+      auto ref = x;
+      for (std::size_t k = 0; k != stages; ++k)
+         ref = run(DS{}, ref);
+
+      q::fast_downsample_cascade<double> cascade{ stages };
+      CHECK(cascade.factor() == (std::size_t(1) << stages));
+
+      std::vector<double> one_at_a_time;
+      for (std::size_t i = 0; i != x.size(); ++i)
+      {
+         CHECK(cascade.phase() == i % cascade.factor());
+         if (cascade(x[i]))
+            one_at_a_time.push_back(cascade.out());
+      }
+      REQUIRE(one_at_a_time.size() == ref.size());
+      for (std::size_t k = 0; k != ref.size(); ++k)
+         CHECK(one_at_a_time[k] == ref[k]);
+
+      for (std::size_t block_size : { 1, 3, 16, 37, 1000 })
+      {
+         INFO("block size: " << block_size);
+         q::fast_downsample_cascade<double> block_cascade{ stages };
+         std::vector<double> blocks, out(block_size);
+         for (std::size_t pos = 0; pos < x.size(); pos += block_size)
+         {
+            auto n = std::min(block_size, x.size() - pos);
+            auto m = block_cascade(x.data() + pos, n, out.data());
+            blocks.insert(blocks.end(), out.begin(), out.begin() + m);
+            CHECK(block_cascade.phase() == (pos + n) % block_cascade.factor());
+         }
+         REQUIRE(blocks.size() == ref.size());
+         for (std::size_t k = 0; k != ref.size(); ++k)
+            CHECK(blocks[k] == ref[k]);
+      }
+   }
+
+   // The number of stages is clamped to max_stages
+   CHECK(q::fast_downsample_cascade<double>{ 9 }.stages() == 4);
+}
@@ -10,6 +10,7 @@
 #include <q/fft/fft.hpp>
 #include <q/support/literals.hpp>
 
+#include <algorithm>
 #include <array>
 #include <complex>
 #include <cmath>
@@ -177,3 +178,124 @@ TEST_CASE("magspec: DC and Nyquist magnitudes", "[fft][magspec]")
          REQUIRE_THAT(d[k], Catch::Matchers::WithinAbs(0.0, eps));
    }
 }
+
+// `rfft`/`irfft`/`rmagspec` operate in place on N real samples. The
+// spectrum is packed into the same N scalars:
+//    data = [ re(0), re(N/2), re(1), im(1), ... , re(N/2-1), im(N/2-1) ]
+// (bins 0 and N/2 of a real signal are real).
+
+namespace
+{
+   // A deterministic real signal for a given size.
+   template <std::size_t N>
+   std::array<double, N> make_real_signal()
+   {
+      std::array<double, N> d{};
+      for (std::size_t n = 0; n != N; ++n)
+         d[n] = std::sin(0.30 * n) + 0.5 * std::cos(0.11 * n * n) - 0.1 * n / double(N);
+      return d;
+   }
+
+   // The same real signal in fft's interleaved layout.
+   template <std::size_t N>
+   std::array<double, 2*N> as_complex(std::array<double, N> const& r)
+   {
+      std::array<double, 2*N> d{};
+      for (std::size_t n = 0; n != N; ++n)
+         d[2*n] = r[n];
+      return d;
+   }
+}
+
+TEMPLATE_TEST_CASE_SIG("rfft matches the naive DFT", "[fft][rfft]",
+   ((std::size_t N), N), 2, 4, 8, 16, 32, 64, 1024)
+{
+   auto d = make_real_signal<N>();
+   auto ref = naive_dft<N>(as_complex<N>(d));
+   q::rfft<N>(d.data());
+
+   REQUIRE_THAT(d[0], Catch::Matchers::WithinAbs(ref[0].real(), 1e-6));
+   REQUIRE_THAT(d[1], Catch::Matchers::WithinAbs(ref[N/2].real(), 1e-6));
+   for (std::size_t k = 1; k != N/2; ++k)
+   {
+      REQUIRE_THAT(d[2*k],   Catch::Matchers::WithinAbs(ref[k].real(), 1e-6));
+      REQUIRE_THAT(d[2*k+1], Catch::Matchers::WithinAbs(ref[k].imag(), 1e-6));
+   }
+}
+
+TEMPLATE_TEST_CASE_SIG("irfft inverts rfft (round trip)", "[fft][irfft]",
+   ((std::size_t N), N), 2, 4, 8, 16, 32, 64, 1024)
+{
+   auto d = make_real_signal<N>();
+   auto orig = d;
+   q::rfft<N>(d.data());
+   q::irfft<N>(d.data());
+   for (std::size_t n = 0; n != N; ++n)
+      REQUIRE_THAT(d[n], Catch::Matchers::WithinAbs(orig[n], 1e-9));
+}
+
+TEST_CASE("irfft: a single bin maps to a real cosine", "[fft][irfft]")
+{
+   constexpr std::size_t N = 32;
+   constexpr std::size_t k0 = 5;
+   std::array<double, N> d{};
+   d[2*k0] = N / 2.0;
+   q::irfft<N>(d.data());
+   for (std::size_t n = 0; n != N; ++n)
+      REQUIRE_THAT(d[n], Catch::Matchers::WithinAbs(std::cos(2.0 * q::pi * k0 * n / N), eps));
+}
+
+TEST_CASE("rfft: float precision at a large size", "[fft][rfft]")
+{
+   constexpr std::size_t N = 4096;
+   std::array<float, N> d{};
+   std::array<double, 2*N> ref{};
+   for (std::size_t n = 0; n != N; ++n)
+   {
+      d[n] = std::sin(0.01 * n) + 0.3f * std::cos(0.7 * n);
+      ref[2*n] = d[n];
+   }
+   q::rfft<N>(d.data());
+   q::fft<N>(ref.data());
+
+   double max_err = 0;
+   for (std::size_t k = 1; k != N/2; ++k)
+   {
+      max_err = std::max(max_err, std::abs(d[2*k] - ref[2*k]));
+      max_err = std::max(max_err, std::abs(d[2*k+1] - ref[2*k+1]));
+   }
+   REQUIRE(max_err < 1e-2);
+}
+
+TEMPLATE_TEST_CASE_SIG("rmagspec equals magspec", "[fft][magspec]",
+   ((std::size_t N), N), 2, 8, 16, 32, 64)
+{
+   auto d = make_real_signal<N>();
+   auto ref = as_complex<N>(d);
+   q::rmagspec<N>(d.data());
+   q::magspec<N>(ref.data());
+   for (std::size_t k = 0; k <= N/2; ++k)
+      REQUIRE_THAT(d[k], Catch::Matchers::WithinAbs(ref[k], 1e-9));
+}
+
+TEMPLATE_TEST_CASE_SIG("fft: float matches double at frame sizes", "[fft]",
+   ((std::size_t N), N), 128, 1024, 2048, 4096)
+{
+   // Covers the vector paths (float only) and both radix-4 stage orders
+   // (log2(N) even and odd).
+   auto ref = make_signal<N>();
+   std::array<float, 2*N> d;
+   std::copy(ref.begin(), ref.end(), d.begin());
+   auto orig = d;
+
+   q::fft<N>(d.data());
+   q::fft<N>(ref.data());
+   double max_err = 0;
+   for (std::size_t i = 0; i != 2*N; ++i)
+      max_err = std::max(max_err, std::abs(d[i] - ref[i]));
+   REQUIRE(max_err < 1e-5 * N);
+
+   q::ifft<N>(d.data());
+   for (std::size_t i = 0; i != 2*N; ++i)
+      REQUIRE_THAT(d[i], Catch::Matchers::WithinAbs(orig[i], 1e-4));
+}
@@ -0,0 +1,209 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/pitch/fft_period_detector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "pitch.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+using namespace notes;
+
+constexpr auto pi = q::pi;
+constexpr auto sps = 44100;
+
+struct harmonics
+{
+   float _1st_level = 0.3f;
+   float _2nd_level = 0.4f;
+   float _3rd_level = 0.3f;
+   float _noise_level = 0.0f;
+};
+
+std::vector<float> gen(q::frequency freq, harmonics const& h, std::size_t size = sps / 4)
+{
+   auto period = as_double(sps / freq);
+   std::mt19937 rng{ 7 };
+   std::uniform_real_distribution<float> noise{ -1.0f, 1.0f };
+
+   std::vector<float> signal(size);
+   for (std::size_t i = 0; i != size; ++i)
+   {
+      auto angle = 2 * pi * i / period;
+      signal[i] = h._1st_level * std::sin(angle)
+         + h._2nd_level * std::sin(2 * angle)
+         + h._3rd_level * std::sin(3 * angle)
+         + h._noise_level * noise(rng);
+   }
+   return signal;
+}
+
+// Run the signal through the detector and return the results of the
+// last analysis.
+template <typename Detector>
+Detector run(std::vector<float> const& in, Detector pd, std::size_t* num_ready = nullptr)
+{
+   std::size_t n = 0;
+   for (auto s : in)
+      n += pd(s);
+   if (num_ready)
+      *num_ready = n;
+   return pd;
+}
+
+void check_period(q::fft_period_detector const& pd, q::frequency freq, float epsilon = 0.001)
+{
+   INFO("frequency: " << as_float(freq));
+   CHECK(pd.fundamental()._period == Approx(sps / as_float(freq)).epsilon(epsilon));
+}
+
+TEST_CASE("Test_fft_period_pure")
+{
+   harmonics h{ 1.0f, 0.0f, 0.0f };
+   std::size_t num_ready = 0;
+   auto pd = run(gen(100_Hz, h), q::fft_period_detector{ 95_Hz, 410_Hz, sps, -30_dB }, &num_ready);
+
+   CHECK(num_ready > 0);
+   check_period(pd, 100_Hz, 0.0001);
+   CHECK(pd.fundamental()._periodicity == Approx(1.0).epsilon(0.001));
+
+   // A sine is anti-correlated at half its period
+   CHECK(pd.harmonic(1) == pd.fundamental()._periodicity);
+   CHECK(pd.harmonic(2) < -0.9f);
+   CHECK(pd.fft_size() >= pd.edges().window_size());
+}
+
+TEST_CASE("Test_fft_period_harmonics")
+{
+   struct
+   {
+      harmonics h;
+      float period_multiple;
+      float harmonic2;
+   }
+   const cases[] =
+   {
+      { { 0.3f, 0.4f, 0.3f }, 1.0f, -0.1f },
+      { { 0.2f, 0.8f, 0.0f }, 1.0f, 0.8f },     // strong 2nd
+      { { 0.4f, 0.0f, 0.6f }, 1.0f, -1.0f },    // strong 3rd
+      { { 0.0f, 0.6f, 0.4f }, 1.0f, -1.0f },    // missing fundamental
+
+      // With a much stronger 2nd, the octave peak is within
+      // peak_threshold of the fundamental's, and wins. The weak
+      // fundamental pulls the octave peak off T/2 a bit.
+      { { 0.1f, 0.9f, 0.0f }, 0.5f, -1.0f },
+   };
+
+   for (auto const& c : cases)
+   {
+      INFO("levels: " << c.h._1st_level << ", " << c.h._2nd_level << ", " << c.h._3rd_level);
+      auto pd = run(gen(100_Hz, c.h), q::fft_period_detector{ 95_Hz, 410_Hz, sps, -30_dB });
+      auto epsilon = (c.period_multiple == 1.0f)? 0.001 : 0.005;
+      CHECK(pd.fundamental()._period == Approx(c.period_multiple * sps / 100).epsilon(epsilon));
+      CHECK(pd.fundamental()._periodicity > 0.95f);
+      CHECK(pd.harmonic(2) >= c.harmonic2);
+   }
+}
+
+TEST_CASE("Test_fft_period_guitar_range")
+{
+   for (auto f : { low_e, a, d, g, b, high_e, low_e_12th, b_24th, high_e_24th })
+   {
+      auto pd = run(gen(f, harmonics{}), q::fft_period_detector{ low_e * 0.8, high_e_24th * 1.2, sps, -30_dB });
+      check_period(pd, f);
+   }
+}
+
+TEST_CASE("Test_fft_period_noise")
+{
+   // With noise, the amplitude information that the bitstream discards
+   // keeps the NSDF on the right period more often.
+   harmonics h{ 0.3f, 0.4f, 0.3f, 0.2f };
+   for (auto f : { a, d, g })
+   {
+      INFO("frequency: " << as_float(f));
+      auto in = gen(f, h, sps);
+      auto period = sps / as_float(f);
+
+      q::fft_period_detector fft_pd{ low_e * 0.8, low_e * 5, sps, -30_dB };
+      q::bacf_period_detector bacf_pd{ low_e * 0.8, low_e * 5, sps, -30_dB };
+
+      std::size_t fft_ready = 0, fft_hits = 0, bacf_hits = 0;
+      for (auto s : in)
+      {
+         if (fft_pd(s))
+         {
+            ++fft_ready;
+            fft_hits += q::rel_within(fft_pd.fundamental()._period, period, 0.005f);
+         }
+         if (bacf_pd(s))
+            bacf_hits += q::rel_within(bacf_pd.fundamental()._period, period, 0.005f);
+      }
+
+      CHECK(fft_ready > 0);
+      CHECK(fft_hits >= fft_ready * 0.8);
+      CHECK(fft_hits >= bacf_hits);
+   }
+}
+
+TEST_CASE("Test_fft_period_silence")
+{
+   std::vector<float> in(sps / 4, 0.0f);
+   auto pd = run(in, q::fft_period_detector{ 95_Hz, 410_Hz, sps, -30_dB });
+   CHECK(pd.fundamental()._period == -1);
+   CHECK(pd.fundamental()._periodicity == 0.0f);
+}
+
+TEST_CASE("Test_fft_period_invalid_range")
+{
+   // The range is checked before anything is allocated
+   CHECK_THROWS_AS((q::fft_period_detector{ 1_Hz, 410_Hz, 192000, -30_dB }), std::runtime_error);
+   CHECK_THROWS_AS((q::fft_period_detector{ 410_Hz, 95_Hz, sps, -30_dB }), std::runtime_error);
+   CHECK_NOTHROW((q::fft_period_detector{ 20_Hz, 410_Hz, 96000, -30_dB }));
+}
+
+TEST_CASE("Test_fft_pitch_detector")
+{
+   // fft_pitch_detector is pitch_detector with the FFT period detector.
+   // Per sample and per block, with the same results.
+   auto in = gen(a, harmonics{}, sps / 2);
+   auto more = gen(d, harmonics{}, sps / 2);
+   in.insert(in.end(), more.begin(), more.end());
+
+   q::fft_pitch_detector pd{ low_e * 0.8, low_e * 5, sps, -45_dB };
+   q::fft_pitch_detector block_pd{ low_e * 0.8, low_e * 5, sps, -45_dB };
+
+   std::size_t const block_size = 300;
+   for (std::size_t pos = 0; pos < in.size(); pos += block_size)
+   {
+      auto n = std::min(block_size, in.size() - pos);
+      std::vector<std::size_t> expected;
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         if (pd(in[pos + i]))
+            expected.push_back(i);
+      }
+
+      auto frames = block_pd.process(in.data() + pos, n);
+      REQUIRE(frames.size() == expected.size());
+      CHECK(std::equal(frames.begin(), frames.end(), expected.begin()));
+      CHECK(block_pd.get_frequency() == pd.get_frequency());
+
+      auto const half = in.size() / 2;
+      if (pos < half && pos + n >= half)
+         CHECK(pd.get_frequency() == Approx(as_float(a)).epsilon(0.001));
+   }
+   CHECK(pd.get_frequency() == Approx(as_float(d)).epsilon(0.001));
+}
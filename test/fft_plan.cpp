@@ -0,0 +1,160 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/fft/fft_plan.hpp>
+
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#if !defined(Q_DONT_USE_THREADS)
+# include <thread>
+#endif
+
+namespace q = cycfi::q;
+
+namespace
+{
+   template <typename T>
+   std::vector<T> make_signal(std::size_t size)
+   {
+      std::vector<T> d(size);
+      for (std::size_t i = 0; i != size; ++i)
+         d[i] = std::sin(0.30 * i) + 0.5 * std::cos(0.11 * i * i);
+      return d;
+   }
+
+   template <typename T>
+   void require_near(std::vector<T> const& a, std::vector<T> const& b, std::size_t n, double eps)
+   {
+      for (std::size_t i = 0; i != n; ++i)
+         REQUIRE_THAT(a[i], Catch::Matchers::WithinAbs(b[i], eps));
+   }
+}
+
+// A plan gives the same results as the compile-time transform of its size
+TEMPLATE_TEST_CASE_SIG("fft_plan matches fft<N>", "[fft_plan]",
+   ((std::size_t N), N), 2, 4, 32, 512, 1024, 2048)
+{
+   q::basic_fft_plan<double> plan{ N };
+   REQUIRE(plan.size() == N);
+
+   SECTION("fft and ifft")
+   {
+      auto d = make_signal<double>(2*N);
+      auto ref = d;
+      plan.fft(d.data());
+      q::fft<N>(ref.data());
+      require_near(d, ref, 2*N, 1e-9);
+
+      plan.ifft(d.data());
+      q::ifft<N>(ref.data());
+      require_near(d, ref, 2*N, 1e-9);
+   }
+   SECTION("rfft and irfft")
+   {
+      auto d = make_signal<double>(N);
+      auto orig = d;
+      auto ref = d;
+      plan.rfft(d.data());
+      q::rfft<N>(ref.data());
+      require_near(d, ref, N, 1e-9);
+
+      plan.irfft(d.data());
+      require_near(d, orig, N, 1e-9);
+   }
+   SECTION("magspec and rmagspec")
+   {
+      auto d = make_signal<double>(2*N);
+      auto ref = d;
+      plan.magspec(d.data());
+      q::magspec<N>(ref.data());
+      require_near(d, ref, N/2 + 1, 1e-9);
+
+      d = make_signal<double>(N);
+      ref = d;
+      plan.rmagspec(d.data());
+      q::rmagspec<N>(ref.data());
+      require_near(d, ref, N/2 + 1, 1e-9);
+   }
+}
+
+TEST_CASE("fft_plan: a runtime size", "[fft_plan]")
+{
+   // A size computed at run time: 2 periods of 41.2 Hz at 48 kHz
+   std::size_t window = 2 * 48000 / 41.2;
+   std::size_t n = cycfi::smallest_pow2(window);
+   q::fft_plan plan{ n };
+   CHECK(n == 4096);
+
+   // A real cosine at bin 100 peaks there, at n/2
+   std::vector<float> d(n);
+   for (std::size_t i = 0; i != n; ++i)
+      d[i] = std::cos(2 * q::pi * 100 * i / n);
+   plan.rmagspec(d.data());
+   CHECK(d[100] == Approx(n / 2.0).epsilon(1e-4));
+   CHECK(d[99] < 0.01f);
+   CHECK(d[101] < 0.01f);
+}
+
+TEST_CASE("fft_plan: copies share the tables", "[fft_plan]")
+{
+   q::fft_plan plan{ 1024 };
+   auto copy = plan;
+   q::fft_plan other{ 64 };
+   other = plan;
+
+   auto a = make_signal<float>(1024);
+   auto b = a;
+   auto c = a;
+   plan.rfft(a.data());
+   copy.rfft(b.data());
+   other.rfft(c.data());
+   CHECK(a == b);
+   CHECK(a == c);
+}
+
+#if !defined(Q_DONT_USE_THREADS)
+TEST_CASE("fft_plan: shared read-only between threads", "[fft_plan]")
+{
+   q::fft_plan const plan{ 2048 };
+   auto ref = make_signal<float>(2048);
+   plan.rfft(ref.data());
+
+   std::array<std::vector<float>, 4> results;
+   std::vector<std::thread> threads;
+   for (auto& r : results)
+   {
+      threads.emplace_back(
+         [&plan, &r]
+         {
+            for (int i = 0; i != 50; ++i)
+            {
+               r = make_signal<float>(2048);
+               plan.rfft(r.data());
+            }
+         }
+      );
+   }
+   for (auto& t : threads)
+      t.join();
+   for (auto const& r : results)
+      CHECK(r == ref);
+}
+#endif
+
+#if __cpp_exceptions == 199711
+TEST_CASE("fft_plan: the size must be a power of 2", "[fft_plan]")
+{
+   CHECK_THROWS_AS(q::fft_plan{ 1000 }, std::runtime_error);
+   CHECK_THROWS_AS(q::fft_plan{ 1 }, std::runtime_error);
+   CHECK_NOTHROW(q::fft_plan{ 2 });
+}
+#endif
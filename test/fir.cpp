@@ -0,0 +1,193 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/fx/fir.hpp>
+#include <q/support/literals.hpp>
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+namespace
+{
+   template <typename T>
+   std::vector<T> noise(std::size_t size, unsigned seed)
+   {
+      std::mt19937 gen(seed);
+      std::uniform_real_distribution<double> dist(-1.0, 1.0);
+      std::vector<T> x(size);
+      for (auto& s : x)
+         s = T(dist(gen));
+      return x;
+   }
+
+   // Direct convolution, y[n] = sum h[k] x[n-k], x[n] = 0 for n < 0
+   template <typename T>
+   std::vector<double> convolve_ref(std::vector<T> const& x, std::vector<T> const& h)
+   {
+      std::vector<double> y(x.size());
+      for (std::size_t n = 0; n != x.size(); ++n)
+      {
+         double acc = 0;
+         for (std::size_t k = 0; k != h.size() && k <= n; ++k)
+            acc += double(h[k]) * x[n - k];
+         y[n] = acc;
+      }
+      return y;
+   }
+
+   // The gain of h at freq (relative to the sample rate)
+   template <typename T>
+   double gain(std::vector<T> const& h, double freq)
+   {
+      std::complex<double> sum = 0;
+      for (std::size_t k = 0; k != h.size(); ++k)
+         sum += double(h[k]) * std::polar(1.0, -2 * q::pi * freq * k);
+      return std::abs(sum);
+   }
+
+   template <typename T>
+   void check_fir(std::size_t taps, double margin)
+   {
+      // Long enough for the history buffer to wrap several times
+      auto h = noise<T>(taps, unsigned(taps));
+      auto x = noise<T>(5000, 7);
+      auto ref = convolve_ref(x, h);
+
+      auto a = q::fir<T>{h};
+      REQUIRE(a.size() == taps);
+      for (std::size_t i = 0; i != x.size(); ++i)
+         REQUIRE(a(x[i]) == Approx(ref[i]).margin(margin));
+
+      // In blocks of odd sizes, in place
+      auto b = q::fir<T>{h};
+      auto y = x;
+      for (std::size_t i = 0; i < y.size(); i += 93)
+      {
+         auto m = std::min<std::size_t>(93, y.size() - i);
+         b.process(y.data() + i, y.data() + i, m);
+      }
+      for (std::size_t i = 0; i != y.size(); ++i)
+         REQUIRE(y[i] == Approx(ref[i]).margin(margin));
+
+      b.reset();
+      for (std::size_t i = 0; i != 100; ++i)
+         REQUIRE(b(x[i]) == Approx(ref[i]).margin(margin));
+   }
+}
+
+TEST_CASE("fir: matches direct convolution")
+{
+   for (std::size_t taps : { 1, 5, 8, 16, 17, 63, 100, 255 })
+   {
+      check_fir<float>(taps, 1e-4);
+      check_fir<double>(taps, 1e-12);
+   }
+}
+
+TEST_CASE("fir_decimator: every factor-th output of the full-rate filter")
+{
+   auto h = q::windowed_sinc(61, 0.2, q::kaiser_beta(60));
+   auto x = noise<float>(6000, 11);
+   auto ref = convolve_ref(x, h);
+
+   for (std::size_t factor : { 1, 2, 3, 4, 8 })
+   {
+      auto d = q::fir_decimator{h, factor};
+      REQUIRE(d.factor() == factor);
+      auto const n = x.size() / factor;
+      std::vector<float> y(n);
+
+      // In two blocks
+      d.process(x.data(), y.data(), n / 2);
+      d.process(x.data() + (n / 2) * factor, y.data() + n / 2, n - n / 2);
+
+      for (std::size_t i = 0; i != n; ++i)
+         REQUIRE(y[i] == Approx(ref[i * factor + factor - 1]).margin(1e-5));
+
+      // In place
+      d.reset();
+      auto z = x;
+      d.process(z.data(), z.data(), n);
+      for (std::size_t i = 0; i != n; ++i)
+         REQUIRE(z[i] == Approx(ref[i * factor + factor - 1]).margin(1e-5));
+   }
+}
+
+TEST_CASE("fir_interpolator: zero-stuffing then filtering")
+{
+   auto h = q::windowed_sinc(97, 0.1, q::kaiser_beta(60));
+   auto x = noise<float>(1000, 13);
+
+   for (std::size_t factor : { 1, 2, 3, 4, 5 })
+   {
+      // The reference: the zero-stuffed input, filtered, times factor
+      std::vector<float> stuffed(x.size() * factor, 0.0f);
+      for (std::size_t i = 0; i != x.size(); ++i)
+         stuffed[i * factor] = x[i];
+      auto ref = convolve_ref(stuffed, h);
+
+      auto u = q::fir_interpolator{h, factor};
+      REQUIRE(u.factor() == factor);
+      std::vector<float> y(stuffed.size());
+      for (std::size_t i = 0; i < x.size(); i += 77)
+      {
+         auto m = std::min<std::size_t>(77, x.size() - i);
+         u.process(x.data() + i, y.data() + i * factor, m);
+      }
+
+      for (std::size_t i = 0; i != y.size(); ++i)
+         REQUIRE(y[i] == Approx(ref[i] * factor).margin(1e-5));
+   }
+}
+
+TEST_CASE("kaiser_lowpass: passband and stopband")
+{
+   constexpr float sps = 48000;
+   for (double attenuation : { 40.0, 60.0, 80.0, 100.0 })
+   {
+      auto h = q::kaiser_lowpass<double>(10_kHz, 2_kHz, sps, attenuation);
+      REQUIRE(h.size() % 2 == 1);
+      REQUIRE(h.size() == q::kaiser_taps(attenuation, 2000 / sps));
+
+      // Symmetric: linear phase
+      for (std::size_t i = 0; i != h.size() / 2; ++i)
+         REQUIRE(h[i] == Approx(h[h.size() - 1 - i]).margin(1e-15));
+
+      auto const ripple = std::pow(10.0, -attenuation / 20);
+      CHECK(gain(h, 0.0) == Approx(1.0).margin(1e-12));
+      CHECK(gain(h, 10000 / sps) == Approx(0.5).margin(ripple));
+
+      // Passband, to 9 kHz
+      for (double f = 0; f <= 9000; f += 250)
+         CHECK(gain(h, f / sps) == Approx(1.0).margin(ripple * 1.1));
+
+      // Stopband, from 11 kHz
+      for (double f = 11000; f <= sps / 2; f += 250)
+         CHECK(gain(h, f / sps) < ripple * 1.1);
+   }
+
+   // Float coefficients
+   auto hf = q::kaiser_lowpass(10_kHz, 2_kHz, sps, 80);
+   CHECK(gain(hf, 0.0) == Approx(1.0).margin(1e-5));
+   for (double f = 11000; f <= sps / 2; f += 250)
+      CHECK(gain(hf, f / sps) < 1e-4);
+}
+
+TEST_CASE("fir: no coefficients")
+{
+   REQUIRE_THROWS_AS(q::fir<float>{std::vector<float>{}}, std::runtime_error);
+   REQUIRE_THROWS_AS((q::fir_decimator<float>{std::vector<float>{}, 2}), std::runtime_error);
+   REQUIRE_THROWS_AS((q::fir_interpolator<float>{std::vector<float>{ 1.0f }, 0}), std::runtime_error);
+}
@@ -0,0 +1,190 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/fx/lookahead_limiter.hpp>
+#include <q/support/literals.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+namespace
+{
+   constexpr float sps = 48000;
+
+   // Noise, with bursts up to 24 dB louder every so often
+   std::vector<float> loud_noise(std::size_t size, unsigned seed)
+   {
+      std::mt19937 gen(seed);
+      std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+      std::vector<float> x(size);
+      for (std::size_t i = 0; i != size; ++i)
+      {
+         auto burst = ((i / 3000) % 3 == 1)? 16.0f : 1.0f;
+         x[i] = burst * dist(gen);
+      }
+      return x;
+   }
+
+   std::vector<float> make_sine(double freq, std::size_t size, double amp)
+   {
+      std::vector<float> d(size);
+      for (std::size_t i = 0; i != size; ++i)
+         d[i] = amp * std::sin(2 * q::pi * freq * i / sps);
+      return d;
+   }
+}
+
+TEST_CASE("lookahead_limiter: brickwall")
+{
+   auto const threshold = q::lin_float(-6_dB);
+   for (auto lookahead : { 0.5_ms, 1_ms, 5_ms })
+   {
+      auto lim = q::lookahead_limiter{lookahead, 50_ms, -6_dB, sps};
+      auto in = loud_noise(48000, 1);
+      std::vector<float> out(in.size());
+      lim.process(in.data(), out.data(), in.size());
+      for (auto s : out)
+         REQUIRE(std::abs(s) <= threshold);
+
+      // Stereo, linked
+      auto lim2 = q::lookahead_limiter{lookahead, 50_ms, -6_dB, sps};
+      auto left = loud_noise(48000, 2);
+      auto right = loud_noise(48000, 3);
+      for (auto& s : right)
+         s *= 0.25f;
+      std::vector<float> out_left(left.size()), out_right(right.size());
+      lim2.process(left.data(), right.data(), out_left.data(), out_right.data(), left.size());
+      for (std::size_t i = 0; i != left.size(); ++i)
+      {
+         REQUIRE(std::abs(out_left[i]) <= threshold);
+         REQUIRE(std::abs(out_right[i]) <= threshold);
+      }
+
+      // The same gain on both channels: the quieter one is limited too
+      auto const latency = lim2.latency();
+      for (std::size_t i = 1000; i != left.size(); ++i)
+      {
+         if (std::abs(right[i - latency]) > 0.1f)
+         {
+            REQUIRE(out_left[i] / left[i - latency]
+               == Approx(out_right[i] / right[i - latency]).epsilon(1e-4));
+         }
+      }
+   }
+}
+
+TEST_CASE("lookahead_limiter: below the threshold")
+{
+   // Below the threshold, the input comes out unchanged, delayed by the
+   // lookahead
+   auto lim = q::lookahead_limiter{2_ms, 50_ms, -1_dB, sps};
+   REQUIRE(lim.latency() == 96);
+
+   auto in = make_sine(1000, 10000, 0.5);
+   std::vector<float> out(in.size());
+   lim.process(in.data(), out.data(), in.size());
+   for (std::size_t i = 0; i != 96; ++i)
+      REQUIRE(out[i] == 0.0f);
+   for (std::size_t i = 96; i != out.size(); ++i)
+      REQUIRE(out[i] == Approx(in[i - 96]).margin(1e-6));
+   CHECK(lim.gain() == Approx(1.0f).margin(1e-6));
+}
+
+TEST_CASE("lookahead_limiter: steady sine")
+{
+   // A sine 6 dB over the threshold, whose period fits the lookahead:
+   // the gain settles at threshold / peak, with no distortion.
+   auto lim = q::lookahead_limiter{5_ms, 100_ms, -6_dB, sps};
+   auto in = make_sine(1000, 24000, 1.0);
+   std::vector<float> out(in.size());
+   lim.process(in.data(), out.data(), in.size());
+
+   auto const threshold = q::lin_float(-6_dB);
+   auto const latency = lim.latency();
+   for (std::size_t i = 2000; i != out.size(); ++i)
+      REQUIRE(out[i] == Approx(in[i - latency] * threshold).margin(1e-4));
+   CHECK(lim.gain() == Approx(threshold).epsilon(1e-4));
+}
+
+TEST_CASE("lookahead_limiter: release")
+{
+   // After a loud burst, the gain comes back to 1, at the release rate
+   auto lim = q::lookahead_limiter{1_ms, 20_ms, -6_dB, sps};
+   auto in = make_sine(1000, 48000, 0.1);
+   for (std::size_t i = 0; i != 4800; ++i)
+      in[i] *= 20;
+   std::vector<float> out(in.size());
+
+   lim.process(in.data(), out.data(), 4800);
+   auto const limited = lim.gain();
+   CHECK(limited < 0.3f);
+
+   lim.process(in.data() + 4800, out.data() + 4800, 480);    // 10 ms
+   auto const partial = lim.gain();
+   CHECK(partial > limited);
+   CHECK(partial < 0.9f);
+
+   lim.process(in.data() + 5280, out.data() + 5280, 9600);   // 200 ms more
+   CHECK(lim.gain() == Approx(1.0f).margin(1e-3));
+}
+
+TEST_CASE("lookahead_limiter: blocks")
+{
+   // Any block size, in place or per sample, gives the same result
+   auto in = loud_noise(20000, 4);
+   auto a = q::lookahead_limiter{3_ms, 50_ms, -3_dB, sps};
+   std::vector<float> expected(in.size());
+   a.process(in.data(), expected.data(), in.size());
+
+   for (std::size_t block_size : { 1, 7, 64, 100, 1000 })
+   {
+      auto b = q::lookahead_limiter{3_ms, 50_ms, -3_dB, sps};
+      auto out = in;
+      for (std::size_t i = 0; i < out.size(); i += block_size)
+      {
+         auto m = std::min(block_size, out.size() - i);
+         b.process(out.data() + i, out.data() + i, m);
+      }
+      REQUIRE(out == expected);
+   }
+
+   auto c = q::lookahead_limiter{3_ms, 50_ms, -3_dB, sps};
+   for (std::size_t i = 0; i != in.size(); ++i)
+      REQUIRE(c(in[i]) == expected[i]);
+
+   // reset starts over
+   c.reset();
+   for (std::size_t i = 0; i != in.size(); ++i)
+      REQUIRE(c(in[i]) == expected[i]);
+}
+
+TEST_CASE("lookahead_limiter: long run")
+{
+   // After 10 minutes of limiting, the gain returns to exactly 1, and
+   // the quiet audio passes unchanged
+   auto lim = q::lookahead_limiter{5_ms, 50_ms, -6_dB, sps};
+   auto noise = loud_noise(48000, 5);
+   std::vector<float> out(noise.size());
+   for (int i = 0; i != 10 * 60; ++i)
+      lim.process(noise.data(), out.data(), noise.size());
+   CHECK(lim.gain() < 1.0f);
+
+   auto quiet = make_sine(1000, 3 * 48000, 0.1);
+   out.resize(quiet.size());
+   lim.process(quiet.data(), out.data(), quiet.size());
+   REQUIRE(lim.gain() == 1.0f);
+
+   auto const latency = lim.latency();
+   for (std::size_t i = 2 * 48000; i != out.size(); ++i)
+      REQUIRE(out[i] == quiet[i - latency]);
+}
@@ -0,0 +1,169 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/fx/modulated_svf.hpp>
+#include <q/support/literals.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace q = cycfi::q;
+using namespace q::literals;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace
+{
+   constexpr float sps = 48000;
+
+   std::vector<float> make_signal(std::size_t size)
+   {
+      std::vector<float> d(size);
+      for (std::size_t i = 0; i != size; ++i)
+         d[i] = 0.6 * std::sin(0.031 * i) + 0.3 * std::sin(0.9 * i * i / size);
+      return d;
+   }
+
+   // An exponential sweep of the cutoff, from 100 Hz to 10 kHz and back
+   std::vector<float> make_sweep(std::size_t size)
+   {
+      std::vector<float> d(size);
+      for (std::size_t i = 0; i != size; ++i)
+      {
+         auto phase = double(i) / size;
+         auto octaves = std::log2(100.0) * (1 - std::cos(2 * q::pi * phase)) / 2;
+         d[i] = 100 * std::exp2(octaves);
+      }
+      return d;
+   }
+
+   // The exact svf cutoff coefficient (svf::cutoff uses fast_tan)
+   float exact_g(double f)
+   {
+      return std::tan(q::pi * f / sps);
+   }
+}
+
+TEST_CASE("cutoff_table: accuracy")
+{
+   auto table = q::cutoff_table{ sps };
+   for (double f = 10; f < 0.45 * sps; f *= 1.01)
+   {
+      auto expected = std::tan(q::pi * f / sps);
+      auto tol = f < 0.4 * sps ? 1e-3 : 5e-3;
+      REQUIRE_THAT(table(float(f)), WithinRel(expected, tol));
+      REQUIRE_THAT(table(q::frequency(f)), WithinRel(expected, tol));
+   }
+
+   // Pitch and frequency index the same table
+   for (float note = 20; note < 130; note += 0.37f)
+   {
+      auto f = float(8.1757989156437 * std::exp2(note / 12.0));
+      REQUIRE_THAT(table(q::pitch(note)), WithinRel(table(f), 3e-4f));
+   }
+
+   // Out of range cutoffs are clamped
+   CHECK(table(0.0f) == table(1.0f));
+   CHECK(table(-100.0f) == table(1.0f));
+   CHECK(table(sps) == table(0.46f * sps));
+   CHECK_THAT(table(sps), WithinRel(exact_g(0.45 * sps), 5e-3f));
+}
+
+TEST_CASE("svf: cutoff from the table")
+{
+   auto table = q::cutoff_table{ sps };
+   auto in = make_signal(1000);
+   auto a = q::svf{ 100_Hz, sps, 2.0 };
+   auto b = q::svf{ 100_Hz, sps, 2.0 };
+   a.cutoff(exact_g(1000));
+   b.cutoff(table(1_kHz));
+   for (auto s : in)
+      REQUIRE_THAT(b(s), WithinAbs(a(s), 1e-3));
+}
+
+TEST_CASE("modulated_svf: constant cutoff matches svf")
+{
+   auto table = q::cutoff_table{ sps };
+   auto in = make_signal(4099);
+   auto cutoff = std::vector<float>(in.size(), 2000.0f);
+
+   auto ref = q::svf{ 2_kHz, sps, 4.0 };
+   ref.cutoff(table(2_kHz));
+   auto f = q::modulated_svf{ table, 2_kHz, 4.0 };
+
+   // In blocks of odd sizes, in place
+   auto out = in;
+   for (std::size_t i = 0; i < out.size(); i += 61)
+   {
+      auto n = std::min<std::size_t>(61, out.size() - i);
+      f.process(out.data() + i, out.data() + i, cutoff.data() + i, n);
+   }
+   for (std::size_t i = 0; i != in.size(); ++i)
+      REQUIRE_THAT(out[i], WithinAbs(ref(in[i]), 1e-4));
+}
+
+TEST_CASE("modulated_svf: sweep follows a per-sample svf")
+{
+   auto table = q::cutoff_table{ sps };
+   auto const size = std::size_t(sps);
+   auto in = make_signal(size);
+   auto cutoff = make_sweep(size);
+
+   for (double r : { 0.5, 0.707, 4.0, 20.0 })
+   {
+      auto ref = q::svf{ 100_Hz, sps, r };
+      auto f = q::modulated_svf{ table, 100_Hz, r };
+
+      std::vector<float> out(size);
+      for (std::size_t i = 0; i < size; i += 256)
+         f.process(in.data() + i, out.data() + i, cutoff.data() + i
+          , std::min<std::size_t>(256, size - i));
+
+      double err = 0, power = 0;
+      for (std::size_t i = 0; i != size; ++i)
+      {
+         ref.cutoff(exact_g(cutoff[i]));
+         auto y = ref(in[i]);
+         REQUIRE(std::isfinite(out[i]));
+         err += (out[i] - y) * (out[i] - y);
+         power += y * y;
+      }
+
+      // The coefficients are ramped linearly between control points:
+      // within 1% (-40 dB) of the per-sample filter
+      CHECK(std::sqrt(err / power) < 0.01);
+   }
+}
+
+TEST_CASE("modulated_svf: glide")
+{
+   auto table = q::cutoff_table{ sps };
+   auto in = make_signal(4096);
+   auto f = q::modulated_svf{ table, 200_Hz };
+   auto g = q::modulated_svf{ table, 200_Hz };
+
+   // A glide to 5 kHz, then hold, matches a constant cutoff array
+   std::vector<float> a(in.size()), b(in.size());
+   f.process(in.data(), a.data(), 5_kHz, 512);
+   std::vector<float> hold(in.size() - 512, 5000.0f);
+   g.process(in.data(), b.data(), 5_kHz, 512);
+   f.process(in.data() + 512, a.data() + 512, hold.data(), hold.size());
+   g.process(in.data() + 512, b.data() + 512, 5_kHz, hold.size());
+   for (std::size_t i = 0; i != in.size(); ++i)
+      REQUIRE_THAT(a[i], WithinAbs(b[i], 1e-5));
+
+   // A steady glide stays at its target
+   auto ref = q::svf{ 5_kHz, sps };
+   ref.cutoff(table(5_kHz));
+   auto h = q::modulated_svf{ table, 5_kHz };
+   std::vector<float> c(in.size());
+   h.process(in.data(), c.data(), 5_kHz, in.size());
+   for (std::size_t i = 0; i != in.size(); ++i)
+      REQUIRE_THAT(c[i], WithinAbs(ref(in[i]), 1e-4));
+}
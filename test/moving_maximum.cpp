@@ -10,6 +10,9 @@
 #include <q/support/literals.hpp>
 #include <q/fx/moving_maximum.hpp>
 
+#include <functional>
+#include <vector>
+
 namespace q = cycfi::q;
 using namespace q::literals;
 
@@ -41,10 +44,127 @@ TEST_CASE("MovingMaximum")
    }
 }
 
+namespace
+{
+   // The reference: the extremum of the last n samples, by brute force
+   template <typename Compare>
+   std::vector<float> brute_force(std::vector<float> const& x, std::size_t n, Compare better)
+   {
+      std::vector<float> y(x.size());
+      for (std::size_t i = 0; i != x.size(); ++i)
+      {
+         auto first = (i + 1 >= n)? i + 1 - n : 0;
+         auto e = x[first];
+         for (auto j = first + 1; j <= i; ++j)
+            if (better(x[j], e))
+               e = x[j];
+         y[i] = e;
+      }
+      return y;
+   }
 
+   std::vector<float> noise(std::size_t size)
+   {
+      std::vector<float> x(size);
+      unsigned r = 12345;
+      for (auto& s : x)
+      {
+         r = r * 1103515245 + 12345;
+         s = float((r >> 8) % 10000) / 10000;
+      }
+      return x;
+   }
 
+   struct counting_greater : std::greater<float>
+   {
+      bool operator()(float a, float b) const
+      {
+         ++count;
+         return a > b;
+      }
 
+      static inline std::size_t count = 0;
+   };
+}
 
+TEST_CASE("MovingMinimum")
+{
+   auto x = noise(2000);
+   for (std::size_t n : { 1, 2, 7, 64, 100 })
+   {
+      auto expected = brute_force(x, n, std::less<float>{});
+      auto mmin = q::moving_minimum<float>{ n };
+      for (std::size_t i = 0; i != x.size(); ++i)
+         CHECK(mmin(x[i]) == expected[i]);
+   }
+}
 
+TEST_CASE("FastMovingMaximum")
+{
+   auto x = noise(5000);
+   for (std::size_t n : { 1, 2, 3, 7, 64, 100, 1000 })
+   {
+      INFO("n = " << n);
+      auto expected = brute_force(x, n, std::greater<float>{});
 
+      // Per sample, same as moving_maximum
+      auto fmax = q::fast_moving_maximum<float>{ n };
+      auto mmax = q::moving_maximum<float>{ n };
+      for (std::size_t i = 0; i != x.size(); ++i)
+      {
+         auto r = fmax(x[i]);
+         CHECK(r == expected[i]);
+         CHECK(r == mmax(x[i]));
+      }
 
+      // In blocks, in place
+      for (std::size_t block_size : { 1, 5, 64, 333 })
+      {
+         auto bmax = q::fast_moving_maximum<float>{ n };
+         auto y = x;
+         for (std::size_t i = 0; i < y.size(); i += block_size)
+         {
+            auto m = std::min(block_size, y.size() - i);
+            bmax.process(y.data() + i, y.data() + i, m);
+         }
+         CHECK(y == expected);
+      }
+
+      // reset starts over
+      fmax.reset();
+      for (std::size_t i = 0; i != 100; ++i)
+         CHECK(fmax(x[i]) == expected[i]);
+   }
+}
+
+TEST_CASE("FastMovingMinimum")
+{
+   auto x = noise(5000);
+   for (std::size_t n : { 1, 4, 100, 480 })
+   {
+      auto expected = brute_force(x, n, std::less<float>{});
+      auto fmin = q::fast_moving_minimum<float>{ n };
+      std::vector<float> y(x.size());
+      fmin.process(x.data(), y.data(), x.size());
+      CHECK(y == expected);
+   }
+
+   // Durations
+   auto fmin = q::fast_moving_minimum<float>{ 10_ms, 48000 };
+   CHECK(fmin.size() == 480);
+}
+
+TEST_CASE("FastMovingMaximumComparisons")
+{
+   // At most three comparisons per sample, for any window size
+   auto x = noise(48000);
+   for (std::size_t n : { 16, 480, 4800 })
+   {
+      auto fmax = q::detail::fast_moving_extremum<float, counting_greater>{ n };
+      std::vector<float> y(x.size());
+      counting_greater::count = 0;
+      fmax.process(x.data(), y.data(), x.size());
+      CHECK(counting_greater::count <= 3 * x.size());
+      CHECK(y == brute_force(x, n, std::greater<float>{}));
+   }
+}
@@ -0,0 +1,125 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/pitch/multi_pitch_detector.hpp>
+
+#include <vector>
+#include "pitch.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+using namespace notes;
+
+constexpr auto pi = q::pi;
+constexpr auto sps = 44100;
+constexpr auto num_strings = 6;
+
+// The open strings of a guitar, one per channel of a hexaphonic pickup
+std::array<q::frequency, num_strings> const strings =
+   { low_e, a, d, g, b, high_e };
+
+std::vector<float> pluck(q::frequency freq, std::size_t size)
+{
+   // A decaying note with some 2nd and 3rd harmonic, followed by silence
+   auto period = as_double(sps / freq);
+   std::vector<float> signal(size);
+   for (std::size_t i = 0; i < size * 3 / 4; ++i)
+   {
+      auto env = std::exp(-double(i) / (sps * 0.4));
+      auto angle = 2 * pi * i / period;
+      signal[i] = env * (0.4 * std::sin(angle)
+         + 0.4 * std::sin(2 * angle + 0.3)
+         + 0.2 * std::sin(3 * angle + 0.6));
+   }
+   return signal;
+}
+
+void check_against_single_channel(std::size_t block_size, std::size_t num_workers)
+{
+   auto const size = sps;
+   std::vector<std::vector<float>> in;
+   std::vector<float const*> channels;
+   for (auto f : strings)
+   {
+      in.push_back(pluck(f, size));
+      channels.push_back(in.back().data());
+   }
+
+   q::multi_pitch_detector<num_strings> mpd{
+      low_e, high_e * 4, sps, -45_dB, num_workers
+   };
+
+   std::vector<q::pitch_detector> ref;
+   for (auto i = 0; i != num_strings; ++i)
+      ref.emplace_back(low_e, high_e * 4, sps, -45_dB);
+
+   std::size_t total_ready = 0;
+   for (std::size_t pos = 0; pos < size; pos += block_size)
+   {
+      auto n = std::min<std::size_t>(block_size, size - pos);
+      std::array<float const*, num_strings> block;
+      for (auto ch = 0; ch != num_strings; ++ch)
+         block[ch] = channels[ch] + pos;
+
+      mpd(q::multi_buffer<float const>{ block.data(), num_strings, n });
+
+      for (auto ch = 0; ch != num_strings; ++ch)
+      {
+         std::size_t num_ready = 0;
+         for (std::size_t i = 0; i != n; ++i)
+            num_ready += ref[ch](channels[ch][pos + i]);
+
+         INFO("channel: " << ch << " frame: " << pos);
+         REQUIRE(mpd.ready_count(ch) == num_ready);
+         REQUIRE(mpd.get_frequency(ch) == ref[ch].get_frequency());
+         REQUIRE(mpd.periodicity(ch) == ref[ch].periodicity());
+         REQUIRE(mpd.is_note_shift(ch) == ref[ch].is_note_shift());
+         total_ready += num_ready;
+      }
+   }
+   CHECK(total_ready > 0);
+}
+
+TEST_CASE("Test_multi_pitch_detector_inline")
+{
+   for (std::size_t block_size : { 1, 32, 256, 1000, 4096 })
+      check_against_single_channel(block_size, 0);
+}
+
+TEST_CASE("Test_multi_pitch_detector_workers")
+{
+   for (std::size_t block_size : { 64, 512 })
+      check_against_single_channel(block_size, 3);
+}
+
+TEST_CASE("Test_multi_pitch_detector_per_channel_range")
+{
+   // Each string with its own detection range
+   auto lowest = strings;
+   auto highest = strings;
+   for (auto ch = 0; ch != num_strings; ++ch)
+   {
+      lowest[ch] = strings[ch] * 0.9;
+      highest[ch] = strings[ch] * 4;
+   }
+   q::multi_pitch_detector<num_strings> mpd{ lowest, highest, sps, -45_dB, 2 };
+
+   std::vector<std::vector<float>> in;
+   std::array<float const*, num_strings> block;
+   for (auto ch = 0; ch != num_strings; ++ch)
+   {
+      in.push_back(pluck(strings[ch], sps / 4));
+      block[ch] = in.back().data();
+   }
+   mpd(q::multi_buffer<float const>{ block.data(), num_strings, sps / 8 });
+
+   for (auto ch = 0; ch != num_strings; ++ch)
+      CHECK(mpd.frequencies()[ch] == Approx(as_float(strings[ch])).epsilon(0.01));
+}
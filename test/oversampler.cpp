@@ -0,0 +1,203 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/fx/oversampler.hpp>
+#include <q/fx/clip.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace q = cycfi::q;
+
+namespace
+{
+   constexpr double sps = 48000;
+
+   std::vector<float> make_sine(double freq, double rate, std::size_t size, double amp = 0.5)
+   {
+      std::vector<float> d(size);
+      for (std::size_t i = 0; i != size; ++i)
+         d[i] = amp * std::sin(2 * q::pi * freq * i / rate);
+      return d;
+   }
+
+   // The amplitude of the freq component of x, past the first skip
+   // samples (the filters' transient), windowed (Hann)
+   double amplitude(std::vector<float> const& x, double freq, double rate, std::size_t skip)
+   {
+      double re = 0, im = 0, wsum = 0;
+      auto const n = x.size() - skip;
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         auto w = 0.5 - 0.5 * std::cos(2 * q::pi * i / n);
+         auto ph = 2 * q::pi * freq * (i + skip) / rate;
+         re += w * x[i + skip] * std::cos(ph);
+         im += w * x[i + skip] * std::sin(ph);
+         wsum += w;
+      }
+      return 2 * std::sqrt(re * re + im * im) / wsum;
+   }
+
+   double db(double a) { return 20 * std::log10(a); }
+
+   template <std::size_t Factor>
+   void check_up_images()
+   {
+      // Upsampled, a sine keeps its amplitude, and its images (at
+      // k x sps -/+ f) are rejected
+      auto os = q::oversampler<Factor>{};
+      for (double f : { 100.0, 1000.0, 10000.0, 20000.0 })
+      {
+         os.reset();
+         auto const n = std::size_t(sps / 4);
+         auto in = make_sine(f, sps, n);
+         std::vector<float> out(n * Factor);
+         os.up(in.data(), out.data(), n);
+
+         auto const rate = sps * Factor;
+         auto const skip = 2000 * Factor;
+         CHECK(amplitude(out, f, rate, skip) == Approx(0.5).margin(1e-4));
+         for (std::size_t k = 1; k != Factor; ++k)
+         {
+            CHECK(db(amplitude(out, k * sps - f, rate, skip) / 0.5) < -90);
+            CHECK(db(amplitude(out, k * sps + f, rate, skip) / 0.5) < -90);
+         }
+      }
+   }
+
+   template <std::size_t Factor>
+   void check_down_rejection()
+   {
+      // Downsampled, what is above sps - 0.46 x sps (which would alias into
+      // the passband) is rejected
+      auto os = q::oversampler<Factor>{};
+      auto const rate = sps * Factor;
+      for (double f : { 0.55 * sps, 0.75 * sps, 0.98 * sps, 1.3 * sps, 0.45 * rate })
+      {
+         if (f >= rate / 2)
+            continue;
+         os.reset();
+         auto const n = std::size_t(sps / 4);
+         auto in = make_sine(f, rate, n * Factor);
+         std::vector<float> out(n);
+         os.down(in.data(), out.data(), n);
+
+         auto alias = std::abs(std::remainder(f, sps));
+         CHECK(db(amplitude(out, alias, sps, 2000) / 0.5) < -90);
+      }
+   }
+
+   template <std::size_t Factor>
+   void check_round_trip()
+   {
+      // Up then down: the passband is flat
+      auto os = q::oversampler<Factor>{};
+      for (double f : { 50.0, 1000.0, 10000.0, 20000.0 })
+      {
+         os.reset();
+         auto const n = std::size_t(sps / 4);
+         auto in = make_sine(f, sps, n);
+         std::vector<float> out(n);
+         os.process(in.data(), out.data(), n, [](float s) { return s; });
+         CHECK(amplitude(out, f, sps, 2000) == Approx(0.5).margin(1e-4));
+      }
+   }
+
+   template <std::size_t Factor>
+   void check_blocks()
+   {
+      // Any block size, in place, gives the same result
+      auto const n = std::size_t(5000);
+      auto in = make_sine(3000, sps, n, 0.9);
+      auto clip = q::cubic_clip{};
+
+      auto a = q::oversampler<Factor>{};
+      std::vector<float> expected(n);
+      a.process(in.data(), expected.data(), n, clip);
+
+      auto b = q::oversampler<Factor>{};
+      auto out = in;
+      for (std::size_t i = 0; i < n; i += 77)
+      {
+         auto m = std::min<std::size_t>(77, n - i);
+         b.process(out.data() + i, out.data() + i, m, clip);
+      }
+      for (std::size_t i = 0; i != n; ++i)
+         REQUIRE(out[i] == Approx(expected[i]).margin(1e-6));
+
+      // up and down, in odd sized blocks, as process
+      auto c = q::oversampler<Factor>{};
+      std::vector<float> up(77 * Factor);
+      for (std::size_t i = 0; i < n; i += 77)
+      {
+         auto m = std::min<std::size_t>(77, n - i);
+         c.up(in.data() + i, up.data(), m);
+         for (std::size_t j = 0; j != m * Factor; ++j)
+            up[j] = clip(up[j]);
+         c.down(up.data(), out.data() + i, m);
+      }
+      for (std::size_t i = 0; i != n; ++i)
+         REQUIRE(out[i] == Approx(expected[i]).margin(1e-6));
+   }
+}
+
+TEST_CASE("oversampler: upsampling rejects the images")
+{
+   check_up_images<2>();
+   check_up_images<4>();
+   check_up_images<8>();
+}
+
+TEST_CASE("oversampler: downsampling rejects the aliases")
+{
+   check_down_rejection<2>();
+   check_down_rejection<4>();
+   check_down_rejection<8>();
+}
+
+TEST_CASE("oversampler: round trip")
+{
+   check_round_trip<2>();
+   check_round_trip<4>();
+   check_round_trip<8>();
+}
+
+TEST_CASE("oversampler: blocks")
+{
+   check_blocks<2>();
+   check_blocks<4>();
+   check_blocks<8>();
+}
+
+TEST_CASE("oversampler: clipping aliases less")
+{
+   // A hard clipped 5 kHz sine: its 7th harmonic (35 kHz) aliases to 13
+   // kHz at 48 kHz. Oversampled by 4, it is filtered out instead; what
+   // remains at 13 kHz are the much weaker harmonics that alias at 192
+   // kHz (the 41st).
+   auto const n = std::size_t(sps / 4);
+   auto in = make_sine(5000, sps, n, 1.0);
+   auto clip = q::hard_clip{ 0.5f };
+
+   std::vector<float> base(n), over(n);
+   for (std::size_t i = 0; i != n; ++i)
+      base[i] = clip(in[i]);
+
+   auto os = q::oversampler<4>{};
+   os.process(in.data(), over.data(), n, clip);
+
+   auto alias_base = db(amplitude(base, 13000, sps, 2000));
+   auto alias_over = db(amplitude(over, 13000, sps, 2000));
+   CHECK(alias_base > -45);
+   CHECK(alias_over < alias_base - 25);
+
+   // The harmonics below Nyquist are kept
+   CHECK(amplitude(over, 5000, sps, 2000) == Approx(amplitude(base, 5000, sps, 2000)).epsilon(0.01));
+   CHECK(amplitude(over, 15000, sps, 2000) == Approx(amplitude(base, 15000, sps, 2000)).epsilon(0.02));
+}
@@ -0,0 +1,169 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/fft/partitioned_convolver.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace q = cycfi::q;
+
+namespace
+{
+   std::vector<float> noise(std::size_t size, unsigned seed)
+   {
+      std::mt19937 rng{ seed };
+      std::uniform_real_distribution<float> dist{ -1.0f, 1.0f };
+      std::vector<float> v(size);
+      for (auto& s : v)
+         s = dist(rng);
+      return v;
+   }
+
+   // A decaying noise burst, like a reverb tail
+   std::vector<float> make_ir(std::size_t size)
+   {
+      auto ir = noise(size, 3);
+      for (std::size_t i = 0; i != size; ++i)
+         ir[i] *= std::exp(-3.0 * i / size);
+      return ir;
+   }
+
+   std::vector<double> direct(std::vector<float> const& x, std::vector<float> const& h)
+   {
+      std::vector<double> y(x.size(), 0.0);
+      for (std::size_t t = 0; t != x.size(); ++t)
+         for (std::size_t j = 0; j != h.size() && j <= t; ++j)
+            y[t] += double(h[j]) * x[t - j];
+      return y;
+   }
+
+   template <typename Convolver>
+   std::vector<float> run(Convolver& conv, std::vector<float> const& x, std::size_t block_size)
+   {
+      std::vector<float> y(x.size());
+      for (std::size_t pos = 0; pos < x.size(); pos += block_size)
+      {
+         auto n = std::min(block_size, x.size() - pos);
+         conv.process(x.data() + pos, y.data() + pos, n);
+      }
+      return y;
+   }
+
+   double max_error(
+      std::vector<float> const& y, std::vector<double> const& ref, std::size_t latency)
+   {
+      double err = 0;
+      for (std::size_t t = latency; t != y.size(); ++t)
+         err = std::max(err, std::abs(y[t] - ref[t - latency]));
+      return err;
+   }
+}
+
+TEST_CASE("Test_partitioned_convolver")
+{
+   auto x = noise(12000, 7);
+   for (std::size_t ir_size : { 1, 100, 256, 3000 })
+   {
+      auto ir = make_ir(ir_size);
+      auto ref = direct(x, ir);
+      for (std::size_t block_size : { 64, 256 })
+      {
+         for (std::size_t host_size : { 1, 37, 64, 256, 1000 })
+         {
+            INFO("ir: " << ir_size << " block: " << block_size << " host: " << host_size);
+            q::partitioned_convolver conv{ ir.data(), ir.size(), block_size };
+            CHECK(conv.latency() == block_size);
+            CHECK(conv.partitions() == (ir_size + block_size - 1) / block_size);
+
+            auto y = run(conv, x, host_size);
+            CHECK(max_error(y, ref, conv.latency()) < 1e-4);
+
+            // The output before the latency is silence
+            for (std::size_t t = 0; t != conv.latency(); ++t)
+               REQUIRE(y[t] == 0.0f);
+         }
+      }
+   }
+}
+
+TEST_CASE("Test_partitioned_convolver_impulse")
+{
+   // An impulse reproduces the IR, delayed by the latency
+   auto ir = make_ir(500);
+   q::partitioned_convolver conv{ ir.data(), ir.size(), 128 };
+   std::vector<float> x(1024, 0.0f);
+   x[0] = 1.0f;
+   auto y = run(conv, x, 128);
+   for (std::size_t i = 0; i != ir.size(); ++i)
+      REQUIRE(y[i + 128] == Approx(ir[i]).margin(1e-5));
+   for (std::size_t i = 128 + ir.size(); i != y.size(); ++i)
+      REQUIRE(y[i] == Approx(0.0f).margin(1e-5));
+}
+
+TEST_CASE("Test_zero_latency_convolver")
+{
+   auto x = noise(30000, 9);
+   for (std::size_t ir_size : { 10, 64, 300, 5000, 25000 })
+   {
+      auto ir = make_ir(ir_size);
+      auto ref = direct(x, ir);
+      for (std::size_t host_size : { 1, 64, 100, 512 })
+      {
+         INFO("ir: " << ir_size << " host: " << host_size);
+         q::zero_latency_convolver conv{ ir.data(), ir.size(), 64, 1024 };
+         CHECK(conv.latency() == 0);
+         auto y = run(conv, x, host_size);
+         CHECK(max_error(y, ref, 0) < 1e-3);
+      }
+   }
+
+   // The segments: 64 (head), then 3 x 64, 3 x 256, and the rest in 1024
+   // sample partitions.
+   auto ir = make_ir(25000);
+   CHECK(q::zero_latency_convolver{ ir.data(), 64 }.segments() == 0);
+   CHECK(q::zero_latency_convolver{ ir.data(), 256, 64, 1024 }.segments() == 1);
+   CHECK(q::zero_latency_convolver{ ir.data(), 25000, 64, 1024 }.segments() == 3);
+}
+
+TEST_CASE("Test_convolver_reset")
+{
+   auto x = noise(5000, 5);
+   auto ir = make_ir(2000);
+   q::zero_latency_convolver conv{ ir.data(), ir.size() };
+   auto a = run(conv, x, 128);
+   conv.reset();
+   auto b = run(conv, x, 128);
+   CHECK(a == b);
+}
+
+TEST_CASE("Test_convolver_in_place")
+{
+   auto x = noise(5000, 5);
+   auto ir = make_ir(2000);
+
+   q::partitioned_convolver pc{ ir.data(), ir.size(), 128 };
+   q::partitioned_convolver pc_ref{ ir.data(), ir.size(), 128 };
+   q::zero_latency_convolver zc{ ir.data(), ir.size() };
+   q::zero_latency_convolver zc_ref{ ir.data(), ir.size() };
+
+   auto y1 = run(pc_ref, x, 100);
+   auto y2 = run(zc_ref, x, 100);
+   auto a = x, b = x;
+   for (std::size_t pos = 0; pos < x.size(); pos += 100)
+   {
+      auto n = std::min<std::size_t>(100, x.size() - pos);
+      pc.process(a.data() + pos, a.data() + pos, n);
+      zc.process(b.data() + pos, b.data() + pos, n);
+   }
+   CHECK(a == y1);
+   CHECK(b == y2);
+}
@@ -664,3 +664,61 @@ TEST_CASE("Test_violin_range")
 
 
 
+
+TEST_CASE("Test_incremental_bitstream")
+{
+   // The bitstream is slid and updated incrementally from one window to
+   // the next. Check that, at every ready state, it is identical to one
+   // built from scratch from the current edges. The signal has a decaying
+   // envelope (the threshold moves with the peak pulse), a note change and
+   // silent gaps (the zero crossing collector resets).
+   std::vector<float> in;
+   for (auto freq : { 82.41, 146.83, 61.74, 392.0 })
+   {
+      auto period = sps / freq;
+      for (auto i = 0; i != sps / 4; ++i)
+      {
+         auto env = std::exp(-i / (sps * 0.1));
+         auto angle = 2 * pi * i / period;
+         in.push_back(env * (0.3 * std::sin(angle) + 0.5 * std::sin(2 * angle)
+            + 0.2 * std::sin(3 * angle + 0.7)));
+      }
+      in.insert(in.end(), sps / 20, 0.0f);
+   }
+
+   // With any overlap (hop = window / overlap), and with some windows left
+   // unanalyzed, which must not leave a stale bitstream behind.
+   for (std::size_t overlap : { 2, 4, 8, 16 })
+   {
+      q::bacf_period_detector pd(50_Hz, 500_Hz, sps, -30_dB, overlap);
+      auto const& edges = pd.edges();
+      q::bitset<> expected{ pd.bits().size() };
+      auto words = pd.bits().size() / pd.bits().value_size;
+      int num_ready = 0;
+
+      for (auto s : in)
+      {
+         if (pd.collect(s))
+         {
+            if (++num_ready % 7 == 0)
+               continue;   // skip this one
+            pd.analyze();
+
+            auto threshold = edges.peak_pulse() * q::bacf_period_detector::pulse_threshold;
+            expected.clear();
+            for (std::size_t i = 0; i != edges.num_edges(); ++i)
+            {
+               auto const& info = edges[i];
+               if (info._peak >= threshold)
+               {
+                  auto pos = std::max<int>(info._leading_edge, 0);
+                  expected.set(pos, info._trailing_edge - pos, 1);
+               }
+            }
+            INFO("overlap: " << overlap << " ready: " << num_ready);
+            REQUIRE(std::equal(expected.data(), expected.data() + words, pd.bits().data()));
+         }
+      }
+      CHECK(num_ready > int(10 * overlap));
+   }
+}
@@ -357,3 +357,141 @@ TEST_CASE("Test_missing_fundamental")
    process(params_, low_e, low_e, "missing_fundamental");
 }
 
+
+TEST_CASE("Test_block_process")
+{
+   // process(in, n) must give the same results as the per-sample call, at
+   // the same frames, for any block size.
+   using namespace notes;
+   params p;
+   auto in = gen_harmonics(low_e, p);
+   auto g = gen_harmonics(g_12th, p);
+   in.insert(in.end(), sps / 10, 0.0f);         // silence resets the collector
+   in.insert(in.end(), g.begin(), g.end());
+
+   for (std::size_t block_size : { 1, 64, 256, 1000 })
+   {
+      q::pitch_detector pd{ low_e, high_e * 4, sps, -45_dB };
+      q::pitch_detector ref{ low_e, high_e * 4, sps, -45_dB };
+      q::bacf_period_detector bacf{ low_e, high_e * 4, sps, -45_dB };
+      std::size_t num_ready = 0;
+
+      for (std::size_t pos = 0; pos < in.size(); pos += block_size)
+      {
+         auto n = std::min(block_size, in.size() - pos);
+         auto const* block = in.data() + pos;
+
+         std::vector<std::size_t> expected;
+         std::vector<float> expected_f;
+         for (std::size_t i = 0; i != n; ++i)
+         {
+            if (ref(block[i]))
+            {
+               expected.push_back(i);
+               expected_f.push_back(ref.get_frequency());
+            }
+         }
+
+         std::size_t k = 0;
+         auto frames = pd.process(block, n,
+            [&](std::size_t frame)
+            {
+               REQUIRE(k < expected_f.size());
+               CHECK(pd.get_frequency() == expected_f[k++]);
+            }
+         );
+         REQUIRE(frames.size() == expected.size());
+         CHECK(std::equal(frames.begin(), frames.end(), expected.begin()));
+
+         auto bacf_frames = bacf.process(block, n);
+         REQUIRE(bacf_frames.size() == expected.size());
+         CHECK(std::equal(bacf_frames.begin(), bacf_frames.end(), expected.begin()));
+         CHECK(bacf.fundamental()._period == ref.get_period_detector().fundamental()._period);
+
+         num_ready += expected.size();
+      }
+      CHECK(pd.get_frequency() == ref.get_frequency());
+      CHECK(num_ready > 100);
+   }
+}
+
+// Placed in static memory: all of its storage is within the object
+using static_detector = q::static_pitch_detector<80, 1400, sps>;
+static_detector static_pd{ -45_dB };
+
+TEST_CASE("Test_static_pitch_detector")
+{
+   // Everything is sized at compile time, as pitch_detector would size it
+   // at run time for the same range and sample rate.
+   using bits_storage = static_detector::bits_type::storage_type;
+   static_assert(std::tuple_size<bits_storage>::value * 64 == static_detector::window_size);
+   static_assert(static_detector::window_size == q::dynamic_window::size(2 * sps / 80));
+
+   using namespace notes;
+   params p;
+   auto in = gen_harmonics(a, p);
+   auto d = gen_harmonics(d_12th, p);
+   in.insert(in.end(), sps / 10, 0.0f);
+   in.insert(in.end(), d.begin(), d.end());
+
+   q::pitch_detector ref{ q::frequency(80.0), q::frequency(1400.0), sps, -45_dB };
+   REQUIRE(static_pd.edges().window_size() == ref.edges().window_size());
+
+   // The results must be identical to pitch_detector, sample by sample and
+   // block by block.
+   auto const block_size = 100;
+   auto const num_words = static_detector::window_size / 64;
+   std::size_t num_ready = 0;
+   for (std::size_t pos = 0; pos < in.size(); pos += block_size)
+   {
+      auto n = std::min<std::size_t>(block_size, in.size() - pos);
+      auto const* block = in.data() + pos;
+
+      std::size_t expected = 0;
+      for (std::size_t i = 0; i != n; ++i)
+         expected += ref(block[i]);
+
+      auto frames = static_pd.process(block, n);
+      REQUIRE(frames.size() == expected);
+      REQUIRE(static_pd.get_frequency() == ref.get_frequency());
+      REQUIRE(static_pd.periodicity() == ref.periodicity());
+      REQUIRE(static_pd.edges().num_edges() == ref.edges().num_edges());
+      REQUIRE(std::equal(
+         static_pd.bits().data(), static_pd.bits().data() + num_words
+       , ref.bits().data()));
+      num_ready += expected;
+   }
+   CHECK(num_ready > 100);
+   CHECK(static_pd.get_frequency() == Approx(as_float(d_12th)).epsilon(0.01));
+}
+
+TEST_CASE("Test_overlap_latency")
+{
+   // A smaller hop (higher overlap) follows a note change sooner
+   using namespace notes;
+   auto const change = sps / 2;
+   std::vector<float> in(sps);
+   for (std::size_t i = 0; i != in.size(); ++i)
+   {
+      auto f = as_double(i < change? a : d);
+      auto angle = 2 * pi * f * i / sps;
+      in[i] = 0.5 * std::sin(angle) + 0.3 * std::sin(2 * angle);
+   }
+
+   std::size_t prev_latency = in.size();
+   for (std::size_t overlap : { 2, 4, 8 })
+   {
+      INFO("overlap: " << overlap);
+      q::pitch_detector pd{ low_e, high_e * 4, sps, -45_dB, overlap };
+      std::size_t latency = in.size();
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         if (pd(in[i]) && i > change && latency == in.size()
+            && pd.get_frequency() == Approx(as_float(d)).epsilon(0.01))
+            latency = i - change;
+      }
+      CHECK(pd.get_frequency() == Approx(as_float(d)).epsilon(0.01));
+      CHECK(latency < prev_latency);
+      prev_latency = latency;
+   }
+}
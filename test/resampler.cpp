@@ -0,0 +1,168 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/fx/resampler.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace q = cycfi::q;
+
+namespace
+{
+   std::vector<float> make_sine(double freq, double sps, std::size_t size, double amp = 0.5)
+   {
+      std::vector<float> d(size);
+      for (std::size_t i = 0; i != size; ++i)
+         d[i] = amp * std::sin(2 * q::pi * freq * i / sps);
+      return d;
+   }
+
+   // Resample all of in, in blocks of block_size, then flush
+   std::vector<float> resample(q::resampler& r, std::vector<float> const& in, std::size_t block_size)
+   {
+      std::vector<float> out(r.max_output(in.size() + r.latency()) + r.max_output(block_size));
+      std::size_t count = 0;
+      for (std::size_t i = 0; i < in.size(); i += block_size)
+      {
+         auto m = std::min(block_size, in.size() - i);
+         count += r.process(in.data() + i, m, out.data() + count);
+      }
+      std::vector<float> zeros(r.latency(), 0.0f);
+      count += r.process(zeros.data(), zeros.size(), out.data() + count);
+      out.resize(count);
+      return out;
+   }
+
+   // The peak error, in dB relative to amp, of a resampled sine, past the
+   // first skip samples
+   double sine_error(
+      q::resampler::quality_type quality, double in_sps, double out_sps
+    , double freq, std::size_t skip = 1000)
+   {
+      auto const amp = 0.5;
+      auto r = q::resampler{in_sps, out_sps, quality};
+      auto out = resample(r, make_sine(freq, in_sps, std::size_t(in_sps / 4), amp), 100);
+
+      double err = 0;
+      for (std::size_t j = skip; j + skip < out.size(); ++j)
+         err = std::max(err, std::abs(out[j] - amp * std::sin(2 * q::pi * freq * j / out_sps)));
+      return 20 * std::log10(err / amp);
+   }
+
+   // The peak level, in dB relative to amp, past the first skip samples
+   double peak_db(std::vector<float> const& x, double amp, std::size_t skip = 1000)
+   {
+      double peak = 0;
+      for (std::size_t j = skip; j + skip < x.size(); ++j)
+         peak = std::max(peak, double(std::abs(x[j])));
+      return 20 * std::log10(peak / amp);
+   }
+}
+
+TEST_CASE("resampler: upsampling, 44.1 kHz to 48 kHz")
+{
+   for (double f : { 100.0, 1000.0, 10000.0, 19000.0 })
+      CHECK(sine_error(q::resampler::high, 44100, 48000, f) < -100);
+
+   for (double f : { 100.0, 1000.0, 10000.0, 17000.0 })
+      CHECK(sine_error(q::resampler::medium, 44100, 48000, f) < -85);
+
+   CHECK(sine_error(q::resampler::hermite, 44100, 48000, 1000) < -80);
+   CHECK(sine_error(q::resampler::linear, 44100, 48000, 100) < -85);
+}
+
+TEST_CASE("resampler: downsampling, 96 kHz to 48 kHz")
+{
+   for (double f : { 1000.0, 15000.0, 20000.0 })
+      CHECK(sine_error(q::resampler::high, 96000, 48000, f) < -100);
+
+   for (double f : { 1000.0, 15000.0, 19000.0 })
+      CHECK(sine_error(q::resampler::medium, 96000, 48000, f) < -85);
+
+   // Above 24 kHz, the aliases are rejected
+   for (double f : { 24500.0, 30000.0, 40000.0, 47000.0 })
+   {
+      auto in = make_sine(f, 96000, 24000);
+      auto rh = q::resampler{96000, 48000, q::resampler::high};
+      auto rm = q::resampler{96000, 48000, q::resampler::medium};
+      CHECK(peak_db(resample(rh, in, 100), 0.5) < -105);
+      CHECK(peak_db(resample(rm, in, 100), 0.5) < -85);
+   }
+}
+
+TEST_CASE("resampler: output count")
+{
+   // After flushing, n inputs make ceil(n x ratio) outputs
+   for (auto quality : { q::resampler::linear, q::resampler::hermite, q::resampler::high })
+   {
+      for (auto [in_sps, out_sps] : { std::pair{44100.0, 48000.0}, { 48000.0, 44100.0 }
+         , { 96000.0, 48000.0 }, { 48000.0, 96000.0 }, { 22050.0, 48000.0 } })
+      {
+         auto r = q::resampler{in_sps, out_sps, quality};
+         auto const n = std::size_t(10007);
+         auto out = resample(r, std::vector<float>(n, 1.0f), 333);
+         CHECK(out.size() == std::size_t(std::ceil(n * out_sps / in_sps)));
+      }
+   }
+}
+
+TEST_CASE("resampler: blocks")
+{
+   // Any block size gives the same result
+   auto in = make_sine(3000, 44100, 20000);
+   auto a = q::resampler{44100, 48000};
+   auto expected = resample(a, in, 20000);
+   for (std::size_t block_size : { 1, 7, 64, 1000, 5000 })
+   {
+      auto b = q::resampler{44100, 48000};
+      auto out = resample(b, in, block_size);
+      REQUIRE(out.size() == expected.size());
+      for (std::size_t i = 0; i != out.size(); ++i)
+         REQUIRE(out[i] == Approx(expected[i]).margin(1e-6));
+   }
+
+   // Copies share the table and resample the same
+   auto c = a;
+   c.reset();
+   a.reset();
+   auto out_a = resample(a, in, 500);
+   auto out_c = resample(c, in, 500);
+   REQUIRE(out_a == out_c);
+   REQUIRE(out_a.size() == expected.size());
+   for (std::size_t i = 0; i != out_a.size(); ++i)
+      REQUIRE(out_a[i] == Approx(expected[i]).margin(1e-6));
+}
+
+TEST_CASE("resampler: variable ratio")
+{
+   // Drift correction: the ratio changes while streaming
+   auto r = q::resampler{48000, 48000};
+   std::vector<float> in(4800, 1.0f);
+   std::vector<float> out(r.max_output(in.size()) * 2);
+
+   auto count = r.process(in.data(), in.size(), out.data());
+   r.ratio(1.01);
+   CHECK(r.ratio() == 1.01);
+   auto more = r.process(in.data(), in.size(), out.data() + count);
+   CHECK(std::abs(double(more) - 4800 * 1.01) < 2);
+
+   // DC passes through the change
+   for (std::size_t i = 1000; i != count + more; ++i)
+      REQUIRE(out[i] == Approx(1.0f).margin(1e-5));
+}
+
+TEST_CASE("resampler: invalid rates")
+{
+   REQUIRE_THROWS_AS((q::resampler{0, 48000}), std::runtime_error);
+   REQUIRE_THROWS_AS((q::resampler{48000, -1}), std::runtime_error);
+   auto r = q::resampler{48000, 44100, q::resampler::linear};
+   REQUIRE_THROWS_AS(r.ratio(0), std::runtime_error);
+}
@@ -0,0 +1,203 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/fx/sos_cascade.hpp>
+#include <q/fx/biquad.hpp>
+#include <q/support/literals.hpp>
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace q = cycfi::q;
+using namespace q::literals;
+using Catch::Matchers::WithinAbs;
+
+namespace
+{
+   constexpr float sps = 48000;
+
+   // The complex frequency response of a cascade at f (Hz)
+   template <std::size_t Sections>
+   std::complex<double> response(q::sos_cascade<Sections> const& f, double freq)
+   {
+      auto z1 = std::polar(1.0, -2 * q::pi * freq / sps);   // z^-1
+      auto z2 = z1 * z1;
+      std::complex<double> h = 1;
+      for (auto const& c : f.coefs)
+      {
+         auto num = double(c.b0) + double(c.b1) * z1 + double(c.b2) * z2;
+         auto den = 1.0 + double(c.a1) * z1 + double(c.a2) * z2;
+         h *= num / den;
+      }
+      return h;
+   }
+
+   template <std::size_t Sections>
+   double gain_db(q::sos_cascade<Sections> const& f, double freq)
+   {
+      return 20 * std::log10(std::abs(response(f, freq)));
+   }
+
+   // The magnitude of a bilinear-transformed Butterworth lowpass
+   double butterworth_db(std::size_t order, double fc, double freq)
+   {
+      auto r = std::tan(q::pi * freq / sps) / std::tan(q::pi * fc / sps);
+      return -10 * std::log10(1 + std::pow(r, 2.0 * order));
+   }
+
+   std::vector<float> make_signal(std::size_t size)
+   {
+      std::vector<float> d(size);
+      for (std::size_t i = 0; i != size; ++i)
+         d[i] = 0.6 * std::sin(0.031 * i) + 0.3 * std::sin(0.9 * i * i / size);
+      return d;
+   }
+
+   template <std::size_t Order>
+   void check_butterworth()
+   {
+      auto lp = q::butterworth_lowpass<Order>{ 1_kHz, sps };
+      auto hp = q::butterworth_highpass<Order>{ 1_kHz, sps };
+      for (double f : { 20.0, 200.0, 700.0, 1000.0, 1500.0, 5000.0, 15000.0 })
+      {
+         auto expected = butterworth_db(Order, 1000, f);
+         if (expected > -80)
+            CHECK_THAT(gain_db(lp, f), WithinAbs(expected, 0.01));
+
+         // The highpass mirrors the lowpass: tan(pi f/sps) inverted
+         auto mirror = sps / q::pi * std::atan(
+            std::pow(std::tan(q::pi * 1000 / sps), 2) / std::tan(q::pi * f / sps));
+         if (expected > -80)
+            CHECK_THAT(gain_db(hp, mirror), WithinAbs(expected, 0.01));
+      }
+   }
+
+   template <std::size_t Order>
+   void check_chebyshev(double ripple)
+   {
+      auto lp = q::chebyshev_lowpass<Order>{ 1_kHz, sps, ripple };
+      auto hp = q::chebyshev_highpass<Order>{ 1_kHz, sps, ripple };
+
+      // The passband ripples between -ripple and 0 dB
+      double lo = 0, hi = -100;
+      for (double f = 1; f < 1000; f += 1)
+      {
+         auto g = gain_db(lp, f);
+         lo = std::min(lo, g);
+         hi = std::max(hi, g);
+      }
+      CHECK_THAT(lo, WithinAbs(-ripple, 0.01));
+      CHECK_THAT(hi, WithinAbs(0.0, 0.01));
+      CHECK_THAT(gain_db(lp, 1000), WithinAbs(-ripple, 0.01));
+
+      lo = 0, hi = -100;
+      for (double f = 1000; f < 23000; f += 10)
+      {
+         auto g = gain_db(hp, f);
+         lo = std::min(lo, g);
+         hi = std::max(hi, g);
+      }
+      CHECK_THAT(lo, WithinAbs(-ripple, 0.01));
+      CHECK_THAT(hi, WithinAbs(0.0, 0.01));
+
+      // Steeper than the Butterworth of the same order, in the stopband
+      auto bw = q::butterworth_lowpass<Order>{ 1_kHz, sps };
+      CHECK(gain_db(lp, 10000) < gain_db(bw, 10000));
+   }
+
+   template <std::size_t Order>
+   void check_linkwitz_riley()
+   {
+      auto lp = q::linkwitz_riley_lowpass<Order>{ 2_kHz, sps };
+      auto hp = q::linkwitz_riley_highpass<Order>{ 2_kHz, sps };
+
+      // -6 dB at the crossover, and the bands sum to a flat response
+      CHECK_THAT(gain_db(lp, 2000), WithinAbs(-6.0206, 0.01));
+      CHECK_THAT(gain_db(hp, 2000), WithinAbs(-6.0206, 0.01));
+      for (double f = 10; f < 23000; f *= 1.1)
+         CHECK_THAT(std::abs(response(lp, f) + response(hp, f)), WithinAbs(1.0, 1e-4));
+   }
+}
+
+TEST_CASE("sos_cascade: butterworth")
+{
+   check_butterworth<1>();
+   check_butterworth<2>();
+   check_butterworth<3>();
+   check_butterworth<4>();
+   check_butterworth<5>();
+   check_butterworth<8>();
+}
+
+TEST_CASE("sos_cascade: butterworth matches cascaded biquads")
+{
+   // A 4th order Butterworth is two biquad lowpass filters with Q =
+   // 0.5412 and 1.3066
+   auto in = make_signal(2000);
+   auto bw = q::butterworth_lowpass<4>{ 500_Hz, sps };
+   auto lp1 = q::lowpass{ 500_Hz, sps, 0.54119610 };
+   auto lp2 = q::lowpass{ 500_Hz, sps, 1.3065630 };
+   for (auto s : in)
+      REQUIRE_THAT(bw(s), WithinAbs(lp2(lp1(s)), 1e-5));
+}
+
+TEST_CASE("sos_cascade: chebyshev")
+{
+   check_chebyshev<2>(1.0);
+   check_chebyshev<3>(0.5);
+   check_chebyshev<4>(1.0);
+   check_chebyshev<5>(0.1);
+   check_chebyshev<6>(3.0);
+}
+
+TEST_CASE("sos_cascade: linkwitz_riley")
+{
+   check_linkwitz_riley<2>();
+   check_linkwitz_riley<4>();
+   check_linkwitz_riley<6>();
+   check_linkwitz_riley<8>();
+}
+
+TEST_CASE("sos_cascade: process matches operator()")
+{
+   auto in = make_signal(4099);
+
+   auto a = q::chebyshev_lowpass<7>{ 3_kHz, sps, 0.5 };
+   auto b = a;
+   std::vector<float> expected(in.size());
+   for (std::size_t i = 0; i != in.size(); ++i)
+      expected[i] = a(in[i]);
+
+   // In blocks of odd sizes, in place
+   auto out = in;
+   for (std::size_t i = 0; i < out.size(); i += 61)
+   {
+      auto n = std::min<std::size_t>(61, out.size() - i);
+      b.process(out.data() + i, out.data() + i, n);
+   }
+   for (std::size_t i = 0; i != in.size(); ++i)
+      REQUIRE_THAT(out[i], WithinAbs(expected[i], 1e-4));
+}
+
+TEST_CASE("sos_cascade: linkwitz_riley_crossover")
+{
+   auto in = make_signal(4096);
+   auto xover = q::linkwitz_riley_crossover<4>{ 1_kHz, sps };
+   auto lp = q::linkwitz_riley_lowpass<4>{ 1_kHz, sps };
+   auto hp = q::linkwitz_riley_highpass<4>{ 1_kHz, sps };
+
+   std::vector<float> low(in.size()), high = in;
+   xover.process(high.data(), low.data(), high.data(), in.size());
+   for (std::size_t i = 0; i != in.size(); ++i)
+   {
+      REQUIRE_THAT(low[i], WithinAbs(lp(in[i]), 1e-4));
+      REQUIRE_THAT(high[i], WithinAbs(hp(in[i]), 1e-4));
+   }
+}
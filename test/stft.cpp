@@ -0,0 +1,161 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+
+#include <q/fft/stft.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace q = cycfi::q;
+
+namespace
+{
+   std::vector<float> noise(std::size_t size)
+   {
+      std::mt19937 rng{ 11 };
+      std::uniform_real_distribution<float> dist{ -1.0f, 1.0f };
+      std::vector<float> in(size);
+      for (auto& s : in)
+         s = dist(rng);
+      return in;
+   }
+
+   std::vector<float> resynthesize(
+      q::stft& st, std::vector<float> const& in, std::size_t block_size)
+   {
+      std::vector<float> out(in.size());
+      for (std::size_t pos = 0; pos < in.size(); pos += block_size)
+      {
+         auto n = std::min(block_size, in.size() - pos);
+         st.process(in.data() + pos, out.data() + pos, n, [](float*) {});
+      }
+      return out;
+   }
+}
+
+TEST_CASE("Test_stft_identity")
+{
+   // An unmodified spectrum reconstructs the input, delayed by latency(),
+   // for any block size and hop.
+   auto in = noise(8000);
+   struct { std::size_t size, hop; } const configs[] =
+   {
+      { 512, 128 }, { 512, 256 }, { 256, 64 }, { 1024, 100 }, { 64, 1 }
+   };
+
+   for (auto c : configs)
+   {
+      for (std::size_t block_size : { 1, 7, 64, 300, 4096 })
+      {
+         INFO("size: " << c.size << " hop: " << c.hop << " block size: " << block_size);
+         q::stft st{ c.size, c.hop };
+         auto out = resynthesize(st, in, block_size);
+
+         auto const latency = st.latency();
+         CHECK(latency == c.size - 1);
+
+         // Past the first frame, where the zero history still overlaps
+         double max_err = 0;
+         for (std::size_t i = latency + c.size; i != in.size(); ++i)
+            max_err = std::max<double>(max_err, std::abs(out[i] - in[i - latency]));
+         CHECK(max_err < 1e-4);
+      }
+   }
+}
+
+TEST_CASE("Test_stft_spectral_gain")
+{
+   // Scaling the spectrum scales the output
+   auto in = noise(4096);
+   q::stft st{ 256, 64 };
+   std::vector<float> out(in.size());
+   std::size_t frames = 0;
+   st.process(in.data(), out.data(), in.size(),
+      [&](float* data)
+      {
+         ++frames;
+         for (std::size_t i = 0; i != st.size(); ++i)
+            data[i] *= 0.5f;
+      }
+   );
+   CHECK(frames == in.size() / 64);
+
+   auto const latency = st.latency();
+   for (std::size_t i = latency + 256; i != in.size(); ++i)
+      REQUIRE(out[i] == Approx(0.5f * in[i - latency]).margin(1e-4));
+}
+
+TEST_CASE("Test_stft_analysis")
+{
+   // A sine at bin 32 of a 1024-point frame
+   std::size_t const size = 1024;
+   std::vector<float> in(size * 8);
+   for (std::size_t i = 0; i != in.size(); ++i)
+      in[i] = std::sin(2 * q::pi * 32 * i / size);
+
+   q::stft st{ size, size / 4 };
+   std::size_t frames = 0;
+   st.analyze(in.data(), in.size(),
+      [&](float const* data)
+      {
+         // Skip the frames that still hold the zero history
+         if (++frames < 4)
+            return;
+         std::size_t peak = 0;
+         float peak_mag = 0;
+         for (std::size_t k = 1; k != size/2; ++k)
+         {
+            auto mag = std::hypot(data[2*k], data[2*k+1]);
+            if (mag > peak_mag)
+            {
+               peak = k;
+               peak_mag = mag;
+            }
+         }
+         CHECK(peak == 32);
+
+         // A Hann window's coherent gain is 0.5: a unit sine reads size/4
+         CHECK(peak_mag == Approx(size / 4.0).epsilon(1e-3));
+      }
+   );
+   CHECK(frames == in.size() / (size / 4));
+}
+
+TEST_CASE("Test_stft_custom_window")
+{
+   // A rectangular window with no overlap is a plain block transform
+   auto in = noise(2048);
+   q::stft st{ 256, 256, [](std::size_t, std::size_t) { return 1.0f; } };
+   CHECK(st.window()[0] == 1.0f);
+
+   auto out = resynthesize(st, in, 100);
+   for (std::size_t i = st.latency(); i != in.size(); ++i)
+      REQUIRE(out[i] == Approx(in[i - st.latency()]).margin(1e-5));
+}
+
+TEST_CASE("Test_stft_reset")
+{
+   auto in = noise(3000);
+   q::stft st{ 256, 64 };
+   auto a = resynthesize(st, in, 64);
+   st.reset();
+   auto b = resynthesize(st, in, 64);
+   CHECK(a == b);
+}
+
+TEST_CASE("Test_stft_invalid_hop")
+{
+   REQUIRE_THROWS_AS((q::stft{ 256, 0 }), std::runtime_error);
+   REQUIRE_THROWS_AS((q::stft{ 256, 257 }), std::runtime_error);
+   REQUIRE_THROWS_AS((q::stft{ 256, std::size_t(-1) }), std::runtime_error);
+   REQUIRE_NOTHROW((q::stft{ 256, 256 }));
+}
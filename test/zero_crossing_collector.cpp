@@ -0,0 +1,161 @@
+/*=============================================================================
+   Copyright (c) 2014-2026 Joel de Guzman. All rights reserved.
+
+   Distributed under the Boost Software License, Version 1.0.
+   [ https://www.boost.org/LICENSE_1_0.txt ]
+=============================================================================*/
+#define CATCH_CONFIG_MAIN
+#include <infra/catch.hpp>
+#include <q/support/literals.hpp>
+#include <q/utility/zero_crossing_collector.hpp>
+#include <q_io/audio_file.hpp>
+#include <random>
+#include <string>
+#include <vector>
+#include "pitch.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+using namespace notes;
+
+void check_same(
+   q::zero_crossing_collector const& zc
+ , q::zero_crossing_collector const& ref)
+{
+   REQUIRE(zc() == ref());
+   REQUIRE(zc.frame() == ref.frame());
+   REQUIRE(zc.is_ready() == ref.is_ready());
+   REQUIRE(zc.is_reset() == ref.is_reset());
+   REQUIRE(zc.num_resets() == ref.num_resets());
+   REQUIRE(zc.peak_pulse() == ref.peak_pulse());
+   REQUIRE(zc.num_edges() == ref.num_edges());
+   for (std::size_t i = 0; i != zc.num_edges(); ++i)
+   {
+      auto const& a = zc[i];
+      auto const& b = ref[i];
+      REQUIRE(a._leading_edge == b._leading_edge);
+      REQUIRE(a._trailing_edge == b._trailing_edge);
+      REQUIRE(a._peak == b._peak);
+      REQUIRE(a._width == b._width);
+      REQUIRE(a._crossing == b._crossing);
+   }
+}
+
+// The block scan must leave the collector in exactly the state the
+// per-sample operator does, at every point where it returns.
+void check_block_scan(
+   std::vector<float> const& in, float sps, q::frequency lowest, std::size_t overlap = 2)
+{
+   for (std::size_t block_size : { 1, 7, 64, 256, 4096 })
+   {
+      INFO("block size: " << block_size);
+      q::zero_crossing_collector zc{ -40_dB, lowest.period() * 2, sps, overlap };
+      q::zero_crossing_collector ref{ -40_dB, lowest.period() * 2, sps, overlap };
+      std::size_t num_ready = 0;
+
+      for (std::size_t pos = 0; pos < in.size(); pos += block_size)
+      {
+         auto n = std::min(block_size, in.size() - pos);
+         auto const* block = in.data() + pos;
+         for (std::size_t i = 0; i != n;)
+         {
+            auto k = zc(block + i, n - i);
+            REQUIRE(k > 0);
+            for (auto end = i + k; i != end; ++i)
+            {
+               ref(block[i]);
+
+               // Only the last sample may be ready
+               if (i + 1 != end)
+                  REQUIRE(!ref.is_ready());
+            }
+            check_same(zc, ref);
+            num_ready += zc.is_ready();
+         }
+      }
+      CHECK(num_ready > 0);
+   }
+}
+
+TEST_CASE("Test_block_scan_audio_files")
+{
+   std::pair<char const*, q::frequency> const files[] =
+   {
+      { "1a-Low-E", low_e },
+      { "-1a-Low-B", low_b },
+      { "3b-D-12th", d },
+      { "6c-High-E-24th", high_e },
+      { "GStaccato", low_e },
+      { "Attack-Reset", low_e },
+   };
+
+   for (auto [name, lowest] : files)
+   {
+      INFO("file: " << name);
+      q::wav_reader src{ std::string{ "audio_files/" } + name + ".wav" };
+      std::vector<float> in(src.length());
+      src.read(in);
+      check_block_scan(in, src.sps(), lowest);
+   }
+}
+
+TEST_CASE("Test_block_scan_noise_and_silence")
+{
+   // Noise bursts around the hysteresis level, and digital silence, hit
+   // the window-end resets and the edge capacity limit.
+   constexpr float sps = 44100;
+   std::mt19937 gen{ 5 };
+   std::normal_distribution<float> noise{ 0.0f, 0.01f };
+   std::vector<float> in;
+   for (auto burst = 0; burst != 8; ++burst)
+   {
+      auto level = 0.2f * burst;
+      for (auto i = 0; i != 4000; ++i)
+         in.push_back(noise(gen) + level * std::sin(i * 0.05f));
+      in.insert(in.end(), 3000, 0.0f);
+   }
+   check_block_scan(in, sps, low_e);
+}
+
+TEST_CASE("Test_overlap")
+{
+   // The window becomes ready every hop = window / overlap frames (or as
+   // soon as the pulse at that point ends) and the block scan still
+   // matches the per-sample operator.
+   constexpr float sps = 44100;
+   std::vector<float> in(sps);
+   auto period = sps / as_float(a);
+   for (std::size_t i = 0; i != in.size(); ++i)
+      in[i] = 0.5f * std::sin(2 * q::pi * i / period);
+
+   std::size_t prev_count = 0;
+   for (std::size_t overlap : { 2, 4, 8, 16 })
+   {
+      INFO("overlap: " << overlap);
+      q::zero_crossing_collector zc{ -40_dB, low_e.period() * 2, sps, overlap };
+      auto const hop = zc.hop_size();
+      CHECK(hop == zc.window_size() / overlap);
+
+      std::size_t count = 0;
+      std::size_t last = 0;
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         zc(in[i]);
+         if (zc.is_ready())
+         {
+            if (count++)
+            {
+               CHECK(i - last >= hop - period);
+               CHECK(i - last <= hop + period);
+            }
+            last = i;
+         }
+      }
+      CHECK(zc.num_hops() == count);
+      if (prev_count)
+         CHECK(count >= prev_count * 2 - 2);
+      prev_count = count;
+
+      check_block_scan(in, sps, low_e, overlap);
+   }
+}